@@ -0,0 +1,424 @@
+#ifndef CONCURRENT_SIGNAL_H
+#define CONCURRENT_SIGNAL_H
+
+#include "Signal.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sig
+{
+	/*******************************************************************************
+	 *                               EpochDomain
+	 *******************************************************************************/
+
+	// Epoch-based reclamation. A reader announces the global epoch it entered
+	// with a plain store followed by a fence, and clears it when leaving: no
+	// read-modify-write on the read side. Writers retire unlinked objects, which
+	// are destroyed once the global epoch has advanced twice since, as that
+	// requires every reader that could still see them to have left.
+	class EpochDomain
+	{
+	public:
+		static EpochDomain &instance()
+		{
+			static EpochDomain domain;
+			return domain;
+		}
+
+		EpochDomain(const EpochDomain &) = delete;
+		EpochDomain &operator=(const EpochDomain &) = delete;
+
+		~EpochDomain()
+		{
+			for (Retired &retired : m_retired)
+			{
+				retired.destroy(retired.object);
+			}
+		}
+
+		void enter()
+		{
+			ThreadRecord &record = localRecord();
+			if (record.nesting++ == 0)
+			{
+				record.epoch.store((m_epoch.load(std::memory_order_relaxed) << 1) | activeBit, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+			}
+		}
+
+		void leave()
+		{
+			ThreadRecord &record = localRecord();
+			if (--record.nesting == 0)
+			{
+				record.epoch.store(0, std::memory_order_release);
+			}
+		}
+
+		// object must already be unreachable for readers entering from now on
+		template <typename T>
+		void retire(T *object)
+		{
+			std::vector<Retired> ready;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_retired.push_back({object, &deleteRetired<T>, m_epoch.load(std::memory_order_relaxed)});
+				ready = collectLocked();
+			}
+			destroy(ready);
+		}
+
+		// Destroys the retired objects no reader can reach anymore
+		void collect()
+		{
+			std::vector<Retired> ready;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				ready = collectLocked();
+			}
+			destroy(ready);
+		}
+
+	private:
+		static constexpr std::uint64_t activeBit = 1;
+
+		struct ThreadRecord
+		{
+			std::atomic<std::uint64_t> epoch{0};
+			unsigned nesting = 0;
+			bool inUse = true;
+		};
+
+		struct Retired
+		{
+			const void *object;
+			void (*destroy)(const void *);
+			std::uint64_t epoch;
+		};
+
+		// Gives the calling thread a record for its lifetime
+		class RecordHolder
+		{
+		public:
+			explicit RecordHolder(EpochDomain &domain)
+				: m_domain(domain), m_record(domain.acquireRecord())
+			{
+			}
+
+			~RecordHolder()
+			{
+				std::lock_guard<std::mutex> lock(m_domain.m_mutex);
+				m_record->inUse = false;
+			}
+
+			ThreadRecord &record()
+			{
+				return *m_record;
+			}
+
+		private:
+			EpochDomain &m_domain;
+			ThreadRecord *m_record;
+		};
+
+		EpochDomain() = default;
+
+		ThreadRecord &localRecord()
+		{
+			thread_local RecordHolder holder(*this);
+			return holder.record();
+		}
+
+		ThreadRecord *acquireRecord()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for (auto &record : m_records)
+			{
+				if (!record->inUse)
+				{
+					record->inUse = true;
+					return record.get();
+				}
+			}
+			m_records.push_back(std::make_unique<ThreadRecord>());
+			return m_records.back().get();
+		}
+
+		// The epoch only moves on once every active reader has observed it
+		bool tryAdvance()
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			std::uint64_t epoch = m_epoch.load(std::memory_order_relaxed);
+			for (auto &record : m_records)
+			{
+				std::uint64_t state = record->epoch.load(std::memory_order_acquire);
+				if ((state & activeBit) && (state >> 1) != epoch)
+				{
+					return false;
+				}
+			}
+			m_epoch.store(epoch + 1, std::memory_order_release);
+			return true;
+		}
+
+		std::vector<Retired> collectLocked()
+		{
+			for (int i = 0; i < 2 && tryAdvance(); ++i)
+			{
+			}
+
+			std::uint64_t epoch = m_epoch.load(std::memory_order_relaxed);
+			std::vector<Retired> ready;
+			std::size_t kept = 0;
+			for (Retired &retired : m_retired)
+			{
+				if (retired.epoch + 2 <= epoch)
+				{
+					ready.push_back(retired);
+				}
+				else
+				{
+					m_retired[kept++] = retired;
+				}
+			}
+			m_retired.resize(kept);
+			return ready;
+		}
+
+		template <typename T>
+		static void deleteRetired(const void *object)
+		{
+			delete static_cast<const T *>(object);
+		}
+
+		static void destroy(std::vector<Retired> &ready)
+		{
+			for (Retired &retired : ready)
+			{
+				retired.destroy(retired.object);
+			}
+		}
+
+		std::mutex m_mutex;
+		std::atomic<std::uint64_t> m_epoch{0};
+		std::vector<std::unique_ptr<ThreadRecord>> m_records;
+		std::vector<Retired> m_retired;
+	};
+
+	// Keeps the calling thread inside the epoch for its scope
+	class EpochGuard
+	{
+	public:
+		explicit EpochGuard(EpochDomain &domain = EpochDomain::instance())
+			: m_domain(domain)
+		{
+			m_domain.enter();
+		}
+
+		~EpochGuard()
+		{
+			m_domain.leave();
+		}
+
+		EpochGuard(const EpochGuard &) = delete;
+		EpochGuard &operator=(const EpochGuard &) = delete;
+
+	private:
+		EpochDomain &m_domain;
+	};
+
+	/*******************************************************************************
+	 *                               ConcurrentSignal
+	 *******************************************************************************/
+
+	// Thread-safe signal. Emitters iterate an immutable snapshot of the slots,
+	// obtained with a single atomic load, without taking any lock or touching
+	// a reference count. connectSlot and disconnectSlot copy the snapshot under
+	// a writer mutex and publish the new one; replaced snapshots and
+	// disconnected slots are reclaimed through the EpochDomain once no
+	// emission can still use them. They are retired after the mutex is
+	// released, so a slot destructor may connect or disconnect. Ids are never
+	// reused.
+	template <typename Signature, typename Combiner = DiscardCombiner, std::size_t SlotBufferSize = defaultSlotBufferSize>
+	class ConcurrentSignal;
+
+	template <typename R, typename... Args, typename Combiner, std::size_t SlotBufferSize>
+	class ConcurrentSignal<R(Args...), Combiner, SlotBufferSize>
+	{
+
+	public:
+		using combiner_type = Combiner;
+		using result_type = typename Combiner::result_type;
+		using signature_type = R(Args...);
+		using slot_type = SlotFunction<signature_type, SlotBufferSize>;
+
+		ConcurrentSignal(Combiner combiner = Combiner())
+			: m_combiner(std::move(combiner)), m_snapshot(new Snapshot())
+		{
+		}
+
+		ConcurrentSignal(const ConcurrentSignal &) = delete;
+		ConcurrentSignal &operator=(const ConcurrentSignal &) = delete;
+
+		// No emission may be running anymore
+		~ConcurrentSignal()
+		{
+			const Snapshot *snapshot = m_snapshot.load(std::memory_order_relaxed);
+			for (const Connection &connection : *snapshot)
+			{
+				delete connection.slot;
+			}
+			delete snapshot;
+		}
+
+		template <typename F>
+		std::size_t connectSlot(F &&callback)
+		{
+			return insert(std::make_unique<slot_type>(std::forward<F>(callback)));
+		}
+
+		template <auto Function>
+		std::size_t connectSlot()
+		{
+			return insert(std::make_unique<slot_type>(slot_type::template bind<Function>()));
+		}
+
+		template <auto Method, typename T>
+		std::size_t connectSlot(T *object)
+		{
+			return insert(std::make_unique<slot_type>(slot_type::template bind<Method>(object)));
+		}
+
+		// Queued connection: callback runs on the thread draining executor
+		template <typename Executor, typename F>
+		std::size_t connectSlot(Executor &executor, F &&callback)
+		{
+			return insert(std::make_unique<slot_type>(queuedSlot<signature_type>(executor, std::forward<F>(callback))));
+		}
+
+		void disconnectSlot(std::size_t id)
+		{
+			const Snapshot *current;
+			slot_type *removed = nullptr;
+			{
+				std::lock_guard<std::mutex> lock(m_writeMutex);
+				current = m_snapshot.load(std::memory_order_relaxed);
+				auto next = std::make_unique<Snapshot>();
+				next->reserve(current->size());
+				for (const Connection &connection : *current)
+				{
+					if (connection.id != id)
+					{
+						next->push_back(connection);
+					}
+					else
+					{
+						removed = connection.slot;
+					}
+				}
+				if (!removed)
+				{
+					return;
+				}
+				m_snapshot.store(next.release(), std::memory_order_release);
+			}
+			EpochDomain &domain = EpochDomain::instance();
+			domain.retire(current);
+			domain.retire(removed);
+		}
+
+		std::size_t slotCount() const
+		{
+			EpochGuard guard;
+			return m_snapshot.load(std::memory_order_acquire)->size();
+		}
+
+		// Slots disconnected during the emission may still be invoked by it,
+		// and stay alive until it returns.
+		template <typename... EmitArgs, typename = std::enable_if_t<sizeof...(EmitArgs) == sizeof...(Args)>>
+		result_type emitSignal(EmitArgs &&...args)
+		{
+			EpochGuard guard;
+			const Snapshot *snapshot = m_snapshot.load(std::memory_order_acquire);
+			return emitArguments(*snapshot, adaptArgument<Args>(std::forward<EmitArgs>(args))...);
+		}
+
+	private:
+		struct Connection
+		{
+			std::size_t id;
+			slot_type *slot;
+		};
+
+		using Snapshot = std::vector<Connection>;
+
+		std::size_t insert(std::unique_ptr<slot_type> slot)
+		{
+			const Snapshot *current;
+			std::size_t id;
+			{
+				std::lock_guard<std::mutex> lock(m_writeMutex);
+				current = m_snapshot.load(std::memory_order_relaxed);
+				auto next = std::make_unique<Snapshot>();
+				next->reserve(current->size() + 1);
+				next->insert(next->end(), current->begin(), current->end());
+				id = m_nextId++;
+				next->push_back({id, slot.release()});
+				m_snapshot.store(next.release(), std::memory_order_release);
+			}
+			EpochDomain::instance().retire(current);
+			return id;
+		}
+
+		template <typename... EmitArgs>
+		result_type emitArguments(const Snapshot &snapshot, EmitArgs &&...args)
+		{
+			if constexpr (std::is_void_v<result_type>)
+			{
+				invokeSlots(snapshot, [](auto &&)
+							{ return true; },
+							std::forward<EmitArgs>(args)...);
+			}
+			else
+			{
+				combiner_type combiner = makeCombiner(m_combiner, snapshot.size());
+				invokeSlots(snapshot, [&](auto &&result)
+							{ return combineItem(combiner, std::forward<decltype(result)>(result)); },
+							std::forward<EmitArgs>(args)...);
+				return combiner.result();
+			}
+		}
+
+		template <typename Sink, typename... EmitArgs>
+		static void invokeSlots(const Snapshot &snapshot, Sink &&sink, EmitArgs &&...args)
+		{
+			using Invocation = SlotInvocation<signature_type, EmitArgs...>;
+			if (snapshot.empty())
+			{
+				return;
+			}
+
+			auto last = snapshot.end() - 1;
+			for (auto connection = snapshot.begin(); connection != last; ++connection)
+			{
+				if (!Invocation::invoke(*connection->slot, sink, args...))
+				{
+					return;
+				}
+			}
+			Invocation::invokeLast(*last->slot, sink, args...);
+		}
+
+		const combiner_type m_combiner;
+		std::mutex m_writeMutex;
+		std::atomic<const Snapshot *> m_snapshot;
+		std::size_t m_nextId = 0;
+	};
+
+}
+
+#endif // CONCURRENT_SIGNAL_H
@@ -0,0 +1,838 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include "Signal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sig
+{
+	constexpr std::size_t cacheLineSize = 64;
+
+	/*******************************************************************************
+	 *                               MpscRing
+	 *******************************************************************************/
+
+	// Bounded lock-free queue for many producers and one consumer (Vyukov).
+	// Each cell carries a sequence number telling whether it is free for the
+	// producer claiming that position or ready for the consumer, so a push is
+	// one compare-exchange and a pop needs no read-modify-write at all.
+	template <typename T>
+	class MpscRing
+	{
+	public:
+		// capacity is rounded up to a power of two
+		explicit MpscRing(std::size_t capacity)
+			: m_mask(roundCapacity(capacity) - 1), m_cells(new Cell[m_mask + 1])
+		{
+			for (std::size_t i = 0; i <= m_mask; ++i)
+			{
+				m_cells[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		MpscRing(const MpscRing &) = delete;
+		MpscRing &operator=(const MpscRing &) = delete;
+
+		~MpscRing()
+		{
+			while (consume([](T &) {}))
+			{
+			}
+		}
+
+		std::size_t capacity() const
+		{
+			return m_mask + 1;
+		}
+
+		// Returns false when the ring is full
+		template <typename... CtorArgs>
+		bool tryPush(CtorArgs &&...args)
+		{
+			std::size_t position = m_enqueue.load(std::memory_order_relaxed);
+			Cell *cell;
+			while (true)
+			{
+				cell = &m_cells[position & m_mask];
+				std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+				if (difference == 0)
+				{
+					if (m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						break;
+					}
+				}
+				else if (difference < 0)
+				{
+					return false;
+				}
+				else
+				{
+					position = m_enqueue.load(std::memory_order_relaxed);
+				}
+			}
+
+			new (&cell->storage) T(std::forward<CtorArgs>(args)...);
+			cell->sequence.store(position + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer only: calls f on the oldest element in place, then frees
+		// its cell. Returns false when the ring is empty.
+		template <typename F>
+		bool consume(F &&f)
+		{
+			Cell &cell = m_cells[m_dequeue & m_mask];
+			if (cell.sequence.load(std::memory_order_acquire) != m_dequeue + 1)
+			{
+				return false;
+			}
+
+			struct Release
+			{
+				~Release()
+				{
+					element->~T();
+					cell.sequence.store(nextSequence, std::memory_order_release);
+				}
+
+				Cell &cell;
+				T *element;
+				std::size_t nextSequence;
+			} release{cell, std::launder(reinterpret_cast<T *>(&cell.storage)), m_dequeue + m_mask + 1};
+			++m_dequeue;
+			f(*release.element);
+			return true;
+		}
+
+	private:
+		struct Cell
+		{
+			std::atomic<std::size_t> sequence;
+			std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+		};
+
+		static std::size_t roundCapacity(std::size_t capacity)
+		{
+			std::size_t rounded = 2;
+			while (rounded < capacity)
+			{
+				rounded *= 2;
+			}
+			return rounded;
+		}
+
+		const std::size_t m_mask;
+		std::unique_ptr<Cell[]> m_cells;
+		alignas(cacheLineSize) std::atomic<std::size_t> m_enqueue{0};
+		alignas(cacheLineSize) std::size_t m_dequeue = 0;
+	};
+
+	/*******************************************************************************
+	 *                               EventLoop
+	 *******************************************************************************/
+
+	// Executor owned by one consumer thread, which runs the posted tasks by
+	// calling drain. Any thread can post. Used as the target of queued
+	// connections: signal.connectSlot(loop, callback).
+	//
+	// The queue holds capacity tasks; other threads posting to a full queue
+	// wait for the consumer to make room. The consumer thread itself, as seen
+	// by its last drain, never waits, since nobody else would make room: its
+	// posts to a full queue go to an unbounded overflow list, run by drain
+	// once the queue is empty. A queued slot may thus emit to queued slots
+	// of its own loop.
+	class EventLoop
+	{
+	public:
+		static constexpr std::size_t taskBufferSize = 6 * sizeof(void *);
+		using task_type = SlotFunction<void(), taskBufferSize>;
+
+		explicit EventLoop(std::size_t capacity = 1024)
+			: m_tasks(capacity)
+		{
+		}
+
+		// Waits for room when the queue is full, except on the consumer thread
+		template <typename F>
+		void post(F &&task)
+		{
+			task_type function(std::forward<F>(task));
+			bool consumer = m_consumer.load(std::memory_order_relaxed) == std::this_thread::get_id();
+			// the consumer keeps its tasks in order behind its overflow
+			if (consumer && !m_overflow.empty())
+			{
+				m_overflow.push_back(std::move(function));
+				return;
+			}
+			while (!m_tasks.tryPush(std::move(function)))
+			{
+				if (consumer)
+				{
+					m_overflow.push_back(std::move(function));
+					return;
+				}
+				std::this_thread::yield();
+			}
+		}
+
+		// Returns false when the queue is full
+		template <typename F>
+		bool tryPost(F &&task)
+		{
+			return m_tasks.tryPush(task_type(std::forward<F>(task)));
+		}
+
+		// Consumer thread only: runs up to maxTasks pending tasks in posting
+		// order and returns how many ran
+		std::size_t drain(std::size_t maxTasks = std::numeric_limits<std::size_t>::max())
+		{
+			m_consumer.store(std::this_thread::get_id(), std::memory_order_relaxed);
+			std::size_t count = 0;
+			while (count < maxTasks)
+			{
+				if (!m_tasks.consume([](task_type &task)
+									 { task(); }))
+				{
+					if (m_overflow.empty())
+					{
+						break;
+					}
+					// the task may post to the overflow list
+					task_type task = std::move(m_overflow.front());
+					m_overflow.pop_front();
+					task();
+				}
+				++count;
+			}
+			return count;
+		}
+
+	private:
+		MpscRing<task_type> m_tasks;
+		std::atomic<std::thread::id> m_consumer{};
+		// consumer thread only
+		std::deque<task_type> m_overflow;
+	};
+
+	/*******************************************************************************
+	 *                               WorkDeque
+	 *******************************************************************************/
+
+	// Unit of work of a ThreadPool, run through a plain function pointer
+	struct PoolJob
+	{
+		void (*run)(PoolJob *);
+	};
+
+	// Fixed-capacity work-stealing deque (Chase-Lev). The owner pushes and
+	// takes at the bottom without contention; thieves take from the top.
+	class WorkDeque
+	{
+	public:
+		static constexpr std::int64_t capacity = 1024;
+
+		// Owner only. Returns false when full.
+		bool push(PoolJob *job)
+		{
+			std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+			std::int64_t top = m_top.load(std::memory_order_acquire);
+			if (bottom - top >= capacity)
+			{
+				return false;
+			}
+			m_jobs[bottom & (capacity - 1)].store(job, std::memory_order_relaxed);
+			m_bottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Owner only: newest job, or nullptr
+		PoolJob *take()
+		{
+			std::int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+			m_bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			std::int64_t top = m_top.load(std::memory_order_relaxed);
+			if (top > bottom)
+			{
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			PoolJob *job = m_jobs[bottom & (capacity - 1)].load(std::memory_order_relaxed);
+			if (top == bottom)
+			{
+				// last job: race the thieves for it
+				if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					job = nullptr;
+				}
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+			return job;
+		}
+
+		// Any thread: oldest job, or nullptr when empty or lost to another thief
+		PoolJob *steal()
+		{
+			std::int64_t top = m_top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			std::int64_t bottom = m_bottom.load(std::memory_order_acquire);
+			if (top >= bottom)
+			{
+				return nullptr;
+			}
+
+			PoolJob *job = m_jobs[top & (capacity - 1)].load(std::memory_order_relaxed);
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				return nullptr;
+			}
+			return job;
+		}
+
+		bool empty() const
+		{
+			return m_top.load(std::memory_order_acquire) >= m_bottom.load(std::memory_order_acquire);
+		}
+
+	private:
+		alignas(cacheLineSize) std::atomic<std::int64_t> m_top{0};
+		alignas(cacheLineSize) std::atomic<std::int64_t> m_bottom{0};
+		std::atomic<PoolJob *> m_jobs[capacity] = {};
+	};
+
+	/*******************************************************************************
+	 *                               ThreadPool
+	 *******************************************************************************/
+
+	// Work-stealing thread pool. Each worker owns a WorkDeque and steals from
+	// the others when its own runs dry; jobs from outside the pool go through
+	// a shared queue. Idle workers spin briefly, then sleep.
+	//
+	// An exception escaping a posted task, or a strand running on the pool,
+	// does not end the worker: it goes to onError, called on that worker and
+	// possibly on several at once. Without a handler the pool keeps the first
+	// one for takeError().
+	class ThreadPool
+	{
+	public:
+		using task_type = SlotFunction<void(), EventLoop::taskBufferSize>;
+		using error_handler = SlotFunction<void(std::exception_ptr)>;
+
+		explicit ThreadPool(unsigned threadCount = std::max(1u, std::thread::hardware_concurrency()),
+							error_handler onError = error_handler())
+			: m_workers(threadCount), m_onError(std::move(onError))
+		{
+			for (unsigned i = 0; i < threadCount; ++i)
+			{
+				m_workers[i].thread = std::thread([this, i]()
+												  { work(i); });
+			}
+		}
+
+		ThreadPool(const ThreadPool &) = delete;
+		ThreadPool &operator=(const ThreadPool &) = delete;
+
+		// Runs the pending jobs, then joins the workers
+		~ThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_stop = true;
+			}
+			m_wake.notify_all();
+			for (Worker &worker : m_workers)
+			{
+				worker.thread.join();
+			}
+		}
+
+		unsigned threadCount() const
+		{
+			return static_cast<unsigned>(m_workers.size());
+		}
+
+		// Executor interface, so the pool can be the target of queued slots
+		template <typename F>
+		void post(F &&task)
+		{
+			submit(new TaskJob(this, task_type(std::forward<F>(task))));
+		}
+
+		// First exception thrown by a posted task since the last call, when
+		// the pool has no error handler
+		std::exception_ptr takeError()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return std::exchange(m_error, nullptr);
+		}
+
+		// Calls f(i) for every i in [0, count), spreading the calls over the
+		// workers and the calling thread, and returns once all are done. The
+		// first exception thrown by f is rethrown, later indices are skipped.
+		template <typename F>
+		void parallelFor(std::size_t count, F &&f)
+		{
+			if (count == 0)
+			{
+				return;
+			}
+
+			ForJob job;
+			job.run = &ForJob::runHelper;
+			job.count = count;
+			job.function = &f;
+			job.call = [](void *function, std::size_t index)
+			{ (*static_cast<std::remove_reference_t<F> *>(function))(index); };
+
+			std::size_t helpers = std::min<std::size_t>(threadCount(), count - 1);
+			job.unfinished.store(helpers, std::memory_order_relaxed);
+			if (Worker *worker = currentWorker())
+			{
+				for (std::size_t i = 0; i < helpers; ++i)
+				{
+					if (!worker->jobs.push(&job))
+					{
+						job.unfinished.fetch_sub(helpers - i, std::memory_order_relaxed);
+						break;
+					}
+				}
+				wakeSleepers();
+			}
+			else
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_injected.insert(m_injected.end(), helpers, &job);
+					m_injectedCount.store(m_injected.size(), std::memory_order_relaxed);
+				}
+				m_wake.notify_all();
+			}
+
+			job.runIndices();
+			while (job.unfinished.load(std::memory_order_acquire) != 0)
+			{
+				if (PoolJob *other = findJob(currentWorker()))
+				{
+					other->run(other);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+
+			if (job.error)
+			{
+				std::rethrow_exception(job.error);
+			}
+		}
+
+	private:
+		struct Worker
+		{
+			WorkDeque jobs;
+			std::thread thread;
+		};
+
+		struct TaskJob : PoolJob
+		{
+			TaskJob(ThreadPool *owner, task_type &&task)
+				: pool(owner), task(std::move(task))
+			{
+				run = [](PoolJob *job)
+				{
+					std::unique_ptr<TaskJob> owned(static_cast<TaskJob *>(job));
+					try
+					{
+						owned->task();
+					}
+					catch (...)
+					{
+						owned->pool->reportError(std::current_exception());
+					}
+				};
+			}
+
+			ThreadPool *pool;
+			task_type task;
+		};
+
+		// Shared by the calling thread and the helpers: every participant
+		// claims indices until none are left
+		struct ForJob : PoolJob
+		{
+			static void runHelper(PoolJob *job)
+			{
+				ForJob *self = static_cast<ForJob *>(job);
+				self->runIndices();
+				self->unfinished.fetch_sub(1, std::memory_order_release);
+			}
+
+			void runIndices()
+			{
+				std::size_t index;
+				while (!failed.load(std::memory_order_relaxed) &&
+					   (index = next.fetch_add(1, std::memory_order_relaxed)) < count)
+				{
+					try
+					{
+						call(function, index);
+					}
+					catch (...)
+					{
+						std::lock_guard<std::mutex> lock(errorMutex);
+						if (!error)
+						{
+							error = std::current_exception();
+						}
+						failed.store(true, std::memory_order_relaxed);
+					}
+				}
+			}
+
+			std::size_t count = 0;
+			void *function = nullptr;
+			void (*call)(void *, std::size_t) = nullptr;
+			std::atomic<std::size_t> next{0};
+			std::atomic<std::size_t> unfinished{0};
+			std::atomic<bool> failed{false};
+			std::mutex errorMutex;
+			std::exception_ptr error;
+		};
+
+		void reportError(std::exception_ptr error)
+		{
+			if (m_onError)
+			{
+				m_onError(std::move(error));
+				return;
+			}
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_error)
+			{
+				m_error = std::move(error);
+			}
+		}
+
+		static ThreadPool *&currentPool()
+		{
+			thread_local ThreadPool *pool = nullptr;
+			return pool;
+		}
+
+		static std::size_t &currentIndex()
+		{
+			thread_local std::size_t index = 0;
+			return index;
+		}
+
+		Worker *currentWorker()
+		{
+			return currentPool() == this ? &m_workers[currentIndex()] : nullptr;
+		}
+
+		void submit(PoolJob *job)
+		{
+			Worker *worker = currentWorker();
+			if (worker && worker->jobs.push(job))
+			{
+				wakeSleepers();
+				return;
+			}
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_injected.push_back(job);
+				m_injectedCount.store(m_injected.size(), std::memory_order_relaxed);
+			}
+			m_wake.notify_one();
+		}
+
+		void wakeSleepers()
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (m_sleepers.load(std::memory_order_relaxed) != 0)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_wake.notify_all();
+			}
+		}
+
+		// Own deque first, then the shared queue, then the other workers
+		PoolJob *findJob(Worker *self)
+		{
+			if (self)
+			{
+				if (PoolJob *job = self->jobs.take())
+				{
+					return job;
+				}
+			}
+			if (m_injectedCount.load(std::memory_order_relaxed) != 0)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (!m_injected.empty())
+				{
+					PoolJob *job = m_injected.front();
+					m_injected.pop_front();
+					m_injectedCount.store(m_injected.size(), std::memory_order_relaxed);
+					return job;
+				}
+			}
+			std::size_t start = self ? static_cast<std::size_t>(self - m_workers.data()) + 1 : 0;
+			for (std::size_t i = 0; i < m_workers.size(); ++i)
+			{
+				Worker &victim = m_workers[(start + i) % m_workers.size()];
+				if (&victim != self)
+				{
+					if (PoolJob *job = victim.jobs.steal())
+					{
+						return job;
+					}
+				}
+			}
+			return nullptr;
+		}
+
+		bool hasWork() const
+		{
+			if (!m_injected.empty())
+			{
+				return true;
+			}
+			for (const Worker &worker : m_workers)
+			{
+				if (!worker.jobs.empty())
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void work(std::size_t index)
+		{
+			currentPool() = this;
+			currentIndex() = index;
+			Worker *self = &m_workers[index];
+			unsigned idle = 0;
+			while (true)
+			{
+				if (PoolJob *job = findJob(self))
+				{
+					job->run(job);
+					idle = 0;
+					continue;
+				}
+				if (++idle < 64)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_sleepers.fetch_add(1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				while (!m_stop && !hasWork())
+				{
+					m_wake.wait(lock);
+				}
+				m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+				if (m_stop && !hasWork())
+				{
+					return;
+				}
+				idle = 0;
+			}
+		}
+
+		std::vector<Worker> m_workers;
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::deque<PoolJob *> m_injected;
+		std::atomic<std::size_t> m_injectedCount{0};
+		std::atomic<unsigned> m_sleepers{0};
+		bool m_stop = false;
+		error_handler m_onError;
+		std::exception_ptr m_error;
+	};
+
+	/*******************************************************************************
+	 *                               Strand
+	 *******************************************************************************/
+
+	// Serial executor on top of another one: tasks posted to a strand run one
+	// at a time, in posting order, on threads of the underlying executor. A
+	// post is an atomic exchange on an intrusive queue (Vyukov) plus a counter
+	// increment; the first task of an idle strand schedules a drain on the
+	// executor. Slots bound to a strand with connectSlot(strand, callback)
+	// never run concurrently. An exception escaping a task propagates out of
+	// the drain to the executor (a ThreadPool reports it) after the remaining
+	// tasks are scheduled, so the strand keeps running.
+	template <typename Executor>
+	class Strand
+	{
+	public:
+		using task_type = SlotFunction<void(), EventLoop::taskBufferSize>;
+
+		// Tasks run before the drain yields the executor to other work
+		static constexpr std::size_t batchSize = 64;
+
+		explicit Strand(Executor &executor)
+			: m_executor(executor)
+		{
+		}
+
+		Strand(const Strand &) = delete;
+		Strand &operator=(const Strand &) = delete;
+
+		// Waits for the pending tasks, so the executor must still run them
+		~Strand()
+		{
+			while (m_pending.load(std::memory_order_acquire) != 0)
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		template <typename F>
+		void post(F &&task)
+		{
+			Node *node = new Node(task_type(std::forward<F>(task)));
+			push(node);
+			if (m_pending.fetch_add(1, std::memory_order_acq_rel) == 0)
+			{
+				schedule();
+			}
+		}
+
+	private:
+		struct Node
+		{
+			Node() = default;
+
+			explicit Node(task_type &&task)
+				: task(std::move(task))
+			{
+			}
+
+			std::atomic<Node *> next{nullptr};
+			task_type task;
+		};
+
+		void schedule()
+		{
+			m_executor.post([this]()
+							{ drain(); });
+		}
+
+		// Runs on the executor, never on two threads at once
+		void drain()
+		{
+			for (std::size_t count = 0; count < batchSize; ++count)
+			{
+				std::unique_ptr<Node> node(popLinked());
+				try
+				{
+					node->task();
+				}
+				catch (...)
+				{
+					if (finishTask())
+					{
+						schedule();
+					}
+					throw;
+				}
+				if (!finishTask())
+				{
+					return;
+				}
+			}
+			schedule();
+		}
+
+		// Whether tasks are left after the one just run
+		bool finishTask()
+		{
+			return m_pending.fetch_sub(1, std::memory_order_acq_rel) != 1;
+		}
+
+		void push(Node *node)
+		{
+			Node *previous = m_head.exchange(node, std::memory_order_acq_rel);
+			previous->next.store(node, std::memory_order_release);
+		}
+
+		// Consumer only: oldest task, or nullptr when the queue is empty or
+		// its next node is still being linked by a producer
+		Node *pop()
+		{
+			Node *tail = m_tail;
+			Node *next = tail->next.load(std::memory_order_acquire);
+			if (tail == &m_stub)
+			{
+				if (!next)
+				{
+					return nullptr;
+				}
+				m_tail = next;
+				tail = next;
+				next = next->next.load(std::memory_order_acquire);
+			}
+			if (next)
+			{
+				m_tail = next;
+				return tail;
+			}
+			if (tail != m_head.load(std::memory_order_acquire))
+			{
+				return nullptr;
+			}
+			push(&m_stub);
+			next = tail->next.load(std::memory_order_acquire);
+			if (next)
+			{
+				m_tail = next;
+				return tail;
+			}
+			return nullptr;
+		}
+
+		// A pending task is known to exist: wait for its producer to link it
+		Node *popLinked()
+		{
+			Node *node;
+			while (!(node = pop()))
+			{
+				std::this_thread::yield();
+			}
+			return node;
+		}
+
+		Executor &m_executor;
+		Node m_stub;
+		alignas(cacheLineSize) std::atomic<Node *> m_head{&m_stub};
+		alignas(cacheLineSize) Node *m_tail = &m_stub;
+		std::atomic<std::size_t> m_pending{0};
+	};
+
+}
+
+#endif // EXECUTOR_H
@@ -0,0 +1,536 @@
+#ifndef FUTURE_H
+#define FUTURE_H
+
+#include "Signal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__linux__) && __has_include(<linux/futex.h>)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define SIG_HAS_FUTEX 1
+#endif
+
+namespace sig
+{
+	/*******************************************************************************
+	 *                               Futex
+	 *******************************************************************************/
+
+	static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex words must be plain 32-bit integers");
+
+	// Blocks while word still holds expected. May return spuriously, so
+	// callers check again. Without futexes the wait degrades to yielding.
+	inline void futexWait(std::atomic<std::uint32_t> &word, std::uint32_t expected)
+	{
+#if defined(SIG_HAS_FUTEX)
+		syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+		while (word.load(std::memory_order_acquire) == expected)
+		{
+			std::this_thread::yield();
+		}
+#endif
+	}
+
+	inline void futexWakeAll(std::atomic<std::uint32_t> &word)
+	{
+#if defined(SIG_HAS_FUTEX)
+		syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+		static_cast<void>(word);
+#endif
+	}
+
+	/*******************************************************************************
+	 *                               StatePool
+	 *******************************************************************************/
+
+	// Free list of State blocks. Each thread keeps a cache, exchanging
+	// batches with a shared depot under a mutex, so blocks released on
+	// another thread than the one which acquired them still come back.
+	template <typename State>
+	class StatePool
+	{
+	public:
+		static State *acquire()
+		{
+			if (!cacheClosed())
+			{
+				std::vector<State *> &states = localCache().states;
+				if (states.empty())
+				{
+					depot().take(states);
+				}
+				if (!states.empty())
+				{
+					State *state = states.back();
+					states.pop_back();
+					return state;
+				}
+			}
+			return new State();
+		}
+
+		static void release(State *state)
+		{
+			if (cacheClosed())
+			{
+				delete state;
+				return;
+			}
+			std::vector<State *> &states = localCache().states;
+			if (states.size() == 2 * batchSize)
+			{
+				depot().give(states.data() + batchSize, states.data() + states.size());
+				states.resize(batchSize);
+			}
+			states.push_back(state);
+		}
+
+	private:
+		static constexpr std::size_t batchSize = 32;
+		static constexpr std::size_t depotCapacity = 64 * batchSize;
+
+		struct Depot
+		{
+			~Depot()
+			{
+				for (State *state : states)
+				{
+					delete state;
+				}
+			}
+
+			void take(std::vector<State *> &cache)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				std::size_t count = std::min(batchSize, states.size());
+				cache.insert(cache.end(), states.end() - count, states.end());
+				states.resize(states.size() - count);
+			}
+
+			// Keeps what fits of [first, last) and deletes the rest
+			void give(State *const *first, State *const *last)
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					std::size_t room = depotCapacity - std::min(depotCapacity, states.size());
+					std::size_t kept = std::min<std::size_t>(room, last - first);
+					states.insert(states.end(), first, first + kept);
+					first += kept;
+				}
+				for (; first != last; ++first)
+				{
+					delete *first;
+				}
+			}
+
+			std::mutex mutex;
+			std::vector<State *> states;
+		};
+
+		struct Cache
+		{
+			Cache()
+			{
+				states.reserve(2 * batchSize);
+			}
+
+			~Cache()
+			{
+				depot().give(states.data(), states.data() + states.size());
+				cacheClosed() = true;
+			}
+
+			std::vector<State *> states;
+		};
+
+		static Depot &depot()
+		{
+			static Depot shared;
+			return shared;
+		}
+
+		static Cache &localCache()
+		{
+			thread_local Cache cache;
+			return cache;
+		}
+
+		// Set once the cache of the thread is gone, during thread exit
+		static bool &cacheClosed()
+		{
+			thread_local bool closed = false;
+			return closed;
+		}
+	};
+
+	/*******************************************************************************
+	 *                               FutureState
+	 *******************************************************************************/
+
+	// State shared by a Promise and its Future, recycled through a StatePool
+	// instead of being allocated per call. The result is published once the
+	// promise is satisfied and every emission work holding the state as its
+	// tracker has completed. The status word doubles as futex for waiters.
+	template <typename T>
+	class FutureState : public EmissionTracker
+	{
+		static_assert(!std::is_reference_v<T>, "futures hold results by value");
+
+	public:
+		struct Release
+		{
+			void operator()(FutureState *state) const noexcept
+			{
+				state->dropReference();
+			}
+		};
+
+		using pointer = std::unique_ptr<FutureState, Release>;
+
+		static pointer create()
+		{
+			return pointer(StatePool<FutureState>::acquire());
+		}
+
+		pointer share() noexcept
+		{
+			m_references.fetch_add(1, std::memory_order_relaxed);
+			return pointer(this);
+		}
+
+		bool isReady() const noexcept
+		{
+			return m_status.load(std::memory_order_acquire) & readyBit;
+		}
+
+		void wait()
+		{
+			std::uint32_t status = m_status.load(std::memory_order_acquire);
+			for (int spin = 0; spin < spinCount && !(status & readyBit); ++spin)
+			{
+				status = m_status.load(std::memory_order_acquire);
+			}
+			while (!(status & readyBit))
+			{
+				status = m_status.fetch_or(waitingBit, std::memory_order_acquire) | waitingBit;
+				if (!(status & readyBit))
+				{
+					futexWait(m_status, status);
+					status = m_status.load(std::memory_order_acquire);
+				}
+			}
+		}
+
+		template <typename... ValueArgs>
+		void setValue(ValueArgs &&...valueArgs)
+		{
+			m_value.emplace(std::forward<ValueArgs>(valueArgs)...);
+			complete();
+		}
+
+		void setException(std::exception_ptr error)
+		{
+			m_error = std::move(error);
+			complete();
+		}
+
+		// Only once ready
+		T take()
+		{
+			if (m_error)
+			{
+				std::rethrow_exception(m_error);
+			}
+			if constexpr (!std::is_void_v<T>)
+			{
+				return std::move(*m_value);
+			}
+		}
+
+		// Runs continuation once ready, right away if it already is
+		void setContinuation(SlotFunction<void()> continuation)
+		{
+			m_continuation = std::move(continuation);
+			if (m_status.fetch_or(continuedBit, std::memory_order_acq_rel) & readyBit)
+			{
+				runContinuation();
+			}
+		}
+
+	private:
+		friend class StatePool<FutureState>;
+
+		static constexpr std::uint32_t readyBit = 1;
+		static constexpr std::uint32_t waitingBit = 2;
+		static constexpr std::uint32_t continuedBit = 4;
+		static constexpr int spinCount = 64;
+
+		using value_type = std::conditional_t<std::is_void_v<T>, bool, T>;
+
+		FutureState() noexcept
+			: EmissionTracker(&retainTracker, &releaseTracker)
+		{
+		}
+
+		static void retainTracker(EmissionTracker *tracker)
+		{
+			FutureState *state = static_cast<FutureState *>(tracker);
+			state->m_references.fetch_add(1, std::memory_order_relaxed);
+			state->m_outstanding.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		static void releaseTracker(EmissionTracker *tracker)
+		{
+			FutureState *state = static_cast<FutureState *>(tracker);
+			state->complete();
+			state->dropReference();
+		}
+
+		// The last of the promise and the tracked work publishes the result
+		void complete()
+		{
+			if (m_outstanding.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			{
+				return;
+			}
+			std::uint32_t previous = m_status.fetch_or(readyBit, std::memory_order_acq_rel);
+			if (previous & waitingBit)
+			{
+				futexWakeAll(m_status);
+			}
+			if (previous & continuedBit)
+			{
+				runContinuation();
+			}
+		}
+
+		void runContinuation()
+		{
+			SlotFunction<void()> continuation = std::move(m_continuation);
+			continuation();
+		}
+
+		void dropReference() noexcept
+		{
+			if (m_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				m_value.reset();
+				m_error = nullptr;
+				m_continuation.reset();
+				m_status.store(0, std::memory_order_relaxed);
+				m_references.store(1, std::memory_order_relaxed);
+				m_outstanding.store(1, std::memory_order_relaxed);
+				StatePool<FutureState>::release(this);
+			}
+		}
+
+		std::atomic<std::uint32_t> m_status{0};
+		std::atomic<std::uint32_t> m_references{1};
+		std::atomic<std::uint32_t> m_outstanding{1};
+		std::optional<value_type> m_value;
+		std::exception_ptr m_error;
+		SlotFunction<void()> m_continuation;
+	};
+
+	/*******************************************************************************
+	 *                               Future
+	 *******************************************************************************/
+
+	template <typename F, typename T>
+	struct ContinuationResult
+	{
+		using type = std::invoke_result_t<F &, T &&>;
+	};
+
+	template <typename F>
+	struct ContinuationResult<F, void>
+	{
+		using type = std::invoke_result_t<F &>;
+	};
+
+	// Receiving end of a Promise. Move-only, one consumer: get() and then()
+	// consume the future.
+	template <typename T>
+	class Future
+	{
+	public:
+		Future() noexcept = default;
+
+		bool valid() const noexcept
+		{
+			return m_state != nullptr;
+		}
+
+		bool isReady() const noexcept
+		{
+			return m_state->isReady();
+		}
+
+		// Spins briefly, then sleeps on the futex until ready
+		void wait() const
+		{
+			m_state->wait();
+		}
+
+		// Waits, then returns the result or rethrows the exception
+		T get()
+		{
+			typename FutureState<T>::pointer state = std::move(m_state);
+			state->wait();
+			return state->take();
+		}
+
+		// Future of f applied to the result, called on the thread completing
+		// this future, or right away when already ready. An exception skips f
+		// and reaches the returned future.
+		template <typename F>
+		auto then(F &&f)
+		{
+			using result_type = typename ContinuationResult<std::decay_t<F>, T>::type;
+
+			Promise<result_type> next;
+			Future<result_type> future = next.getFuture();
+			FutureState<T> *state = m_state.get();
+			state->setContinuation([state = std::move(m_state), next = std::move(next), f = std::decay_t<F>(std::forward<F>(f))]() mutable
+								   { next.setResultOf([&]() -> result_type
+													  {
+														  if constexpr (std::is_void_v<T>)
+														  {
+															  state->take();
+															  return f();
+														  }
+														  else
+														  {
+															  return f(state->take());
+														  } }); });
+			return future;
+		}
+
+	private:
+		friend class Promise<T>;
+
+		explicit Future(typename FutureState<T>::pointer state) noexcept
+			: m_state(std::move(state))
+		{
+		}
+
+		typename FutureState<T>::pointer m_state;
+	};
+
+	/*******************************************************************************
+	 *                               Promise
+	 *******************************************************************************/
+
+	// Producing end of a Future, satisfied once. Destroying an unsatisfied
+	// promise breaks it: the future gets a std::future_error.
+	template <typename T>
+	class Promise
+	{
+	public:
+		Promise()
+			: m_state(FutureState<T>::create())
+		{
+		}
+
+		Promise(Promise &&) noexcept = default;
+		Promise &operator=(Promise &&) = delete;
+
+		~Promise()
+		{
+			if (m_state)
+			{
+				setException(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+			}
+		}
+
+		// Only once
+		Future<T> getFuture()
+		{
+			return Future<T>(m_state->share());
+		}
+
+		template <typename... ValueArgs>
+		void setValue(ValueArgs &&...valueArgs)
+		{
+			if constexpr (std::is_void_v<T>)
+			{
+				static_assert(sizeof...(ValueArgs) == 0, "void promises take no value");
+				m_state->setValue(true);
+			}
+			else
+			{
+				m_state->setValue(std::forward<ValueArgs>(valueArgs)...);
+			}
+			m_state.reset();
+		}
+
+		void setException(std::exception_ptr error)
+		{
+			m_state->setException(std::move(error));
+			m_state.reset();
+		}
+
+		// Satisfies the promise with the result of f, or what it throws
+		template <typename F>
+		void setResultOf(F &&f)
+		{
+			try
+			{
+				if constexpr (std::is_void_v<T>)
+				{
+					std::forward<F>(f)();
+					setValue();
+				}
+				else
+				{
+					setValue(std::forward<F>(f)());
+				}
+			}
+			catch (...)
+			{
+				if (m_state)
+				{
+					setException(std::current_exception());
+				}
+			}
+		}
+
+		// Same, with the promise as emission tracker of the thread while f
+		// runs: the future also waits for the work f hands to executors.
+		template <typename F>
+		void track(F &&f)
+		{
+			struct Scope
+			{
+				~Scope()
+				{
+					EmissionTracker::current() = previous;
+				}
+
+				EmissionTracker *previous;
+			} scope{std::exchange(EmissionTracker::current(), m_state.get())};
+			setResultOf(std::forward<F>(f));
+		}
+
+	private:
+		typename FutureState<T>::pointer m_state;
+	};
+
+}
+
+#endif // FUTURE_H
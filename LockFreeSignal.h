@@ -0,0 +1,616 @@
+#ifndef LOCK_FREE_SIGNAL_H
+#define LOCK_FREE_SIGNAL_H
+
+#include "Signal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<linux/membarrier.h>)
+#define SIG_HAS_MEMBARRIER 1
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace sig
+{
+	/*******************************************************************************
+	 *                               HazardDomain
+	 *******************************************************************************/
+
+	// Hazard pointer reclamation. A thread publishes the nodes it is about to
+	// dereference in its record; retired nodes are only destroyed once no
+	// record holds them. Records are never freed, only reused, so scanning
+	// them needs no lock. Nested emissions take one record per level.
+	class HazardDomain
+	{
+	public:
+		static constexpr std::size_t slotsPerRecord = 4;
+
+		struct Record
+		{
+			std::atomic<const void *> hazards[slotsPerRecord] = {};
+			std::atomic<bool> active{true};
+			Record *next = nullptr;
+		};
+
+		static HazardDomain &instance()
+		{
+			static HazardDomain domain;
+			return domain;
+		}
+
+		HazardDomain(const HazardDomain &) = delete;
+		HazardDomain &operator=(const HazardDomain &) = delete;
+
+		~HazardDomain()
+		{
+			for (Retired &retired : m_orphans)
+			{
+				retired.destroy(retired.object);
+			}
+			Record *record = m_records.load(std::memory_order_relaxed);
+			while (record)
+			{
+				Record *next = record->next;
+				delete record;
+				record = next;
+			}
+		}
+
+		// Record for the calling thread's current nesting level
+		Record &enter()
+		{
+			ThreadState &state = localState();
+			if (state.depth == state.frames.size())
+			{
+				state.frames.push_back(acquireRecord());
+			}
+			return *state.frames[state.depth++];
+		}
+
+		void leave(Record &record)
+		{
+			for (auto &hazard : record.hazards)
+			{
+				hazard.store(nullptr, std::memory_order_release);
+			}
+			--localState().depth;
+		}
+
+		// object must already be unreachable from the shared structure
+		template <typename T>
+		void retire(T *object)
+		{
+			ThreadState &state = localState();
+			state.retired.push_back({object, &deleteRetired<T>});
+			if (state.retired.size() >= scanThreshold())
+			{
+				scan(state.retired);
+			}
+		}
+
+		// Orders a hazard store before the loads validating it. With membarrier
+		// this is only a compiler barrier, the scan pays for both sides.
+		void lightFence() const
+		{
+			if (m_asymmetric)
+			{
+				std::atomic_signal_fence(std::memory_order_seq_cst);
+			}
+			else
+			{
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+			}
+		}
+
+		// Destroys the objects retired by the calling thread that no hazard
+		// protects anymore
+		void collect()
+		{
+			scan(localState().retired);
+		}
+
+	private:
+		struct Retired
+		{
+			const void *object;
+			void (*destroy)(const void *);
+		};
+
+		struct ThreadState
+		{
+			explicit ThreadState(HazardDomain &domain)
+				: domain(domain)
+			{
+			}
+
+			~ThreadState()
+			{
+				for (Record *record : frames)
+				{
+					record->active.store(false, std::memory_order_release);
+				}
+				domain.scan(retired);
+				std::lock_guard<std::mutex> lock(domain.m_orphanMutex);
+				domain.m_orphans.insert(domain.m_orphans.end(), retired.begin(), retired.end());
+			}
+
+			HazardDomain &domain;
+			std::vector<Record *> frames;
+			std::size_t depth = 0;
+			std::vector<Retired> retired;
+		};
+
+		HazardDomain()
+		{
+#if defined(SIG_HAS_MEMBARRIER)
+			m_asymmetric = syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+#endif
+		}
+
+		void heavyFence() const
+		{
+#if defined(SIG_HAS_MEMBARRIER)
+			if (m_asymmetric)
+			{
+				syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+				return;
+			}
+#endif
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+		}
+
+		ThreadState &localState()
+		{
+			thread_local ThreadState state(*this);
+			return state;
+		}
+
+		Record *acquireRecord()
+		{
+			for (Record *record = m_records.load(std::memory_order_acquire); record; record = record->next)
+			{
+				bool active = false;
+				if (!record->active.load(std::memory_order_relaxed) &&
+					record->active.compare_exchange_strong(active, true, std::memory_order_acquire))
+				{
+					return record;
+				}
+			}
+
+			Record *record = new Record();
+			Record *head = m_records.load(std::memory_order_relaxed);
+			do
+			{
+				record->next = head;
+			} while (!m_records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+			m_recordCount.fetch_add(1, std::memory_order_relaxed);
+			return record;
+		}
+
+		std::size_t scanThreshold() const
+		{
+			return std::max<std::size_t>(64, 2 * slotsPerRecord * m_recordCount.load(std::memory_order_relaxed));
+		}
+
+		void scan(std::vector<Retired> &retired)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_orphanMutex, std::try_to_lock);
+				if (lock.owns_lock())
+				{
+					retired.insert(retired.end(), m_orphans.begin(), m_orphans.end());
+					m_orphans.clear();
+				}
+			}
+
+			heavyFence();
+			std::vector<const void *> hazards;
+			for (Record *record = m_records.load(std::memory_order_acquire); record; record = record->next)
+			{
+				for (auto &hazard : record->hazards)
+				{
+					if (const void *pointer = hazard.load(std::memory_order_acquire))
+					{
+						hazards.push_back(pointer);
+					}
+				}
+			}
+			std::sort(hazards.begin(), hazards.end());
+
+			std::vector<Retired> ready;
+			std::size_t kept = 0;
+			for (Retired &item : retired)
+			{
+				if (std::binary_search(hazards.begin(), hazards.end(), item.object))
+				{
+					retired[kept++] = item;
+				}
+				else
+				{
+					ready.push_back(item);
+				}
+			}
+			retired.resize(kept);
+
+			// Destructors run last, as they may retire in turn
+			for (Retired &item : ready)
+			{
+				item.destroy(item.object);
+			}
+		}
+
+		template <typename T>
+		static void deleteRetired(const void *object)
+		{
+			delete static_cast<const T *>(object);
+		}
+
+		std::atomic<Record *> m_records{nullptr};
+		std::atomic<std::size_t> m_recordCount{0};
+		std::mutex m_orphanMutex;
+		std::vector<Retired> m_orphans;
+		bool m_asymmetric = false;
+	};
+
+	// Hazard slots of the calling thread for its scope
+	class HazardFrame
+	{
+	public:
+		explicit HazardFrame(HazardDomain &domain = HazardDomain::instance())
+			: m_domain(domain), m_record(domain.enter())
+		{
+		}
+
+		~HazardFrame()
+		{
+			m_domain.leave(m_record);
+		}
+
+		HazardFrame(const HazardFrame &) = delete;
+		HazardFrame &operator=(const HazardFrame &) = delete;
+
+		// Publishes pointer; the caller must validate it is still reachable
+		void set(std::size_t index, const void *pointer)
+		{
+			m_record.hazards[index].store(pointer, std::memory_order_relaxed);
+			m_domain.lightFence();
+		}
+
+	private:
+		HazardDomain &m_domain;
+		HazardDomain::Record &m_record;
+	};
+
+	/*******************************************************************************
+	 *                               LockFreeSignal
+	 *******************************************************************************/
+
+	// Thread-safe signal for heavy subscription churn. Slots live in a
+	// lock-free linked list ordered by id (Harris-Michael), so connect and
+	// disconnect never copy the slot table nor take a lock, and emitters never
+	// block. Nodes are reclaimed through the HazardDomain. Slots connected or
+	// disconnected while an emission runs may or may not be invoked by it.
+	template <typename Signature, typename Combiner = DiscardCombiner, std::size_t SlotBufferSize = defaultSlotBufferSize>
+	class LockFreeSignal;
+
+	template <typename R, typename... Args, typename Combiner, std::size_t SlotBufferSize>
+	class LockFreeSignal<R(Args...), Combiner, SlotBufferSize>
+	{
+
+	public:
+		using combiner_type = Combiner;
+		using result_type = typename Combiner::result_type;
+		using signature_type = R(Args...);
+		using slot_type = SlotFunction<signature_type, SlotBufferSize>;
+
+		LockFreeSignal(Combiner combiner = Combiner())
+			: m_combiner(std::move(combiner))
+		{
+		}
+
+		LockFreeSignal(const LockFreeSignal &) = delete;
+		LockFreeSignal &operator=(const LockFreeSignal &) = delete;
+
+		// No other operation may be running anymore
+		~LockFreeSignal()
+		{
+			Node *node = pointer(m_head.load(std::memory_order_relaxed));
+			while (node)
+			{
+				Node *next = pointer(node->next.load(std::memory_order_relaxed));
+				delete node;
+				node = next;
+			}
+		}
+
+		template <typename F>
+		std::size_t connectSlot(F &&callback)
+		{
+			return insert(new Node(slot_type(std::forward<F>(callback))));
+		}
+
+		template <auto Function>
+		std::size_t connectSlot()
+		{
+			return insert(new Node(slot_type::template bind<Function>()));
+		}
+
+		template <auto Method, typename T>
+		std::size_t connectSlot(T *object)
+		{
+			return insert(new Node(slot_type::template bind<Method>(object)));
+		}
+
+		// Queued connection: callback runs on the thread draining executor
+		template <typename Executor, typename F>
+		std::size_t connectSlot(Executor &executor, F &&callback)
+		{
+			return insert(new Node(slot_type(queuedSlot<signature_type>(executor, std::forward<F>(callback)))));
+		}
+
+		void disconnectSlot(std::size_t id)
+		{
+			HazardFrame frame;
+			while (true)
+			{
+				Window window = find(frame, id);
+				if (!window.curr || window.curr->id != id)
+				{
+					return;
+				}
+
+				std::uintptr_t next = window.curr->next.load(std::memory_order_acquire);
+				if (isMarked(next))
+				{
+					return;
+				}
+				if (!window.curr->next.compare_exchange_strong(next, next | markBit, std::memory_order_acq_rel))
+				{
+					continue;
+				}
+
+				m_count.fetch_sub(1, std::memory_order_relaxed);
+				std::uintptr_t expected = link(window.curr);
+				if (window.prev->compare_exchange_strong(expected, next, std::memory_order_acq_rel))
+				{
+					retire(window.curr);
+				}
+				else
+				{
+					find(frame, id);
+				}
+				return;
+			}
+		}
+
+		std::size_t slotCount() const
+		{
+			return m_count.load(std::memory_order_relaxed);
+		}
+
+		template <typename... EmitArgs, typename = std::enable_if_t<sizeof...(EmitArgs) == sizeof...(Args)>>
+		result_type emitSignal(EmitArgs &&...args)
+		{
+			return emitArguments(adaptArgument<Args>(std::forward<EmitArgs>(args))...);
+		}
+
+	private:
+		static constexpr std::uintptr_t markBit = 1;
+
+		// Hazard slots: find uses the first two, emission the last two
+		enum HazardSlot : std::size_t
+		{
+			PrevSlot,
+			FoundSlot,
+			CurrentSlot,
+			NextSlot
+		};
+
+		struct Node
+		{
+			explicit Node(slot_type &&slot)
+				: slot(std::move(slot))
+			{
+			}
+
+			std::size_t id = 0;
+			slot_type slot;
+			// successor, with markBit set once the node is disconnected
+			std::atomic<std::uintptr_t> next{0};
+		};
+
+		struct Window
+		{
+			std::atomic<std::uintptr_t> *prev;
+			Node *curr;
+		};
+
+		static Node *pointer(std::uintptr_t link)
+		{
+			return reinterpret_cast<Node *>(link & ~markBit);
+		}
+
+		static std::uintptr_t link(Node *node)
+		{
+			return reinterpret_cast<std::uintptr_t>(node);
+		}
+
+		static bool isMarked(std::uintptr_t link)
+		{
+			return link & markBit;
+		}
+
+		// First live node whose id is at least key, and the link pointing to
+		// it. Unlinks the disconnected nodes met on the way.
+		Window find(HazardFrame &frame, std::size_t key)
+		{
+		retry:
+			std::atomic<std::uintptr_t> *prev = &m_head;
+			Node *curr = pointer(prev->load(std::memory_order_acquire));
+			while (curr)
+			{
+				frame.set(FoundSlot, curr);
+				if (prev->load(std::memory_order_acquire) != link(curr))
+				{
+					goto retry;
+				}
+
+				std::uintptr_t next = curr->next.load(std::memory_order_acquire);
+				if (isMarked(next))
+				{
+					std::uintptr_t expected = link(curr);
+					if (!prev->compare_exchange_strong(expected, next & ~markBit, std::memory_order_acq_rel))
+					{
+						goto retry;
+					}
+					retire(curr);
+					curr = pointer(next);
+					continue;
+				}
+
+				if (curr->id >= key)
+				{
+					return {prev, curr};
+				}
+				frame.set(PrevSlot, curr);
+				prev = &curr->next;
+				curr = pointer(next);
+			}
+			return {prev, nullptr};
+		}
+
+		// Ids grow, so a new node almost always goes after the last one: it is
+		// appended there directly, the list only searched when that fails.
+		std::size_t insert(Node *node)
+		{
+			node->id = m_nextId.fetch_add(1, std::memory_order_relaxed);
+			HazardFrame frame;
+			while (!append(frame, node))
+			{
+				Window window = find(frame, node->id);
+				node->next.store(link(window.curr), std::memory_order_relaxed);
+				std::uintptr_t expected = link(window.curr);
+				if (window.prev->compare_exchange_strong(expected, link(node), std::memory_order_release))
+				{
+					if (!window.curr)
+					{
+						m_tail.store(node, std::memory_order_release);
+					}
+					break;
+				}
+			}
+			m_count.fetch_add(1, std::memory_order_relaxed);
+			return node->id;
+		}
+
+		// Links node after the tail hint, if that is still the last node and
+		// has a lower id. The hint only ever points to a node of this list:
+		// it is set to nodes not yet returned by connect, which cannot be
+		// disconnected, and cleared before a node is retired.
+		bool append(HazardFrame &frame, Node *node)
+		{
+			Node *tail = m_tail.load(std::memory_order_acquire);
+			if (!tail)
+			{
+				return false;
+			}
+			frame.set(PrevSlot, tail);
+			if (m_tail.load(std::memory_order_acquire) != tail || tail->id > node->id)
+			{
+				return false;
+			}
+			std::uintptr_t expected = 0;
+			if (!tail->next.compare_exchange_strong(expected, link(node), std::memory_order_release))
+			{
+				return false;
+			}
+			m_tail.store(node, std::memory_order_release);
+			return true;
+		}
+
+		void retire(Node *node)
+		{
+			Node *tail = node;
+			m_tail.compare_exchange_strong(tail, nullptr, std::memory_order_acq_rel);
+			HazardDomain::instance().retire(node);
+		}
+
+		// Successor of a protected node, protected in NextSlot
+		Node *successor(HazardFrame &frame, Node *node)
+		{
+			std::uintptr_t next = node->next.load(std::memory_order_acquire);
+			if (!isMarked(next))
+			{
+				frame.set(NextSlot, pointer(next));
+				if (node->next.load(std::memory_order_acquire) == next)
+				{
+					return pointer(next);
+				}
+			}
+
+			// node was disconnected meanwhile: search again, ids are ordered
+			Node *found = find(frame, node->id + 1).curr;
+			frame.set(NextSlot, found);
+			return found;
+		}
+
+		template <typename... EmitArgs>
+		result_type emitArguments(EmitArgs &&...args)
+		{
+			if constexpr (std::is_void_v<result_type>)
+			{
+				invokeSlots([](auto &&)
+							{ return true; },
+							std::forward<EmitArgs>(args)...);
+			}
+			else
+			{
+				combiner_type combiner = makeCombiner(m_combiner, slotCount());
+				invokeSlots([&](auto &&result)
+							{ return combineItem(combiner, std::forward<decltype(result)>(result)); },
+							std::forward<EmitArgs>(args)...);
+				return combiner.result();
+			}
+		}
+
+		template <typename Sink, typename... EmitArgs>
+		void invokeSlots(Sink &&sink, EmitArgs &&...args)
+		{
+			using Invocation = SlotInvocation<signature_type, EmitArgs...>;
+			HazardFrame frame;
+			Node *node = find(frame, 0).curr;
+			while (node)
+			{
+				frame.set(CurrentSlot, node);
+				Node *next = successor(frame, node);
+				if (!next)
+				{
+					Invocation::invokeLast(node->slot, sink, args...);
+					return;
+				}
+				if (!Invocation::invoke(node->slot, sink, args...))
+				{
+					return;
+				}
+				node = next;
+			}
+		}
+
+		const combiner_type m_combiner;
+		std::atomic<std::uintptr_t> m_head{0};
+		// last node appended, a hint for the next one
+		std::atomic<Node *> m_tail{nullptr};
+		std::atomic<std::size_t> m_nextId{0};
+		std::atomic<std::size_t> m_count{0};
+	};
+
+}
+
+#endif // LOCK_FREE_SIGNAL_H
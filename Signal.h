@@ -1,12 +1,35 @@
 #ifndef SIGNAL_H
 #define SIGNAL_H
 
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
-#include <map>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 
 namespace sig
 {
+	// A combiner whose combine() returns Combine::Stop ends the emission: the
+	// remaining slots are not invoked.
+	enum class Combine
+	{
+		Continue,
+		Stop
+	};
+
 	/*******************************************************************************
 	 *                               DiscardCombiner
 	 *******************************************************************************/
@@ -57,6 +80,17 @@ namespace sig
 		void combine(U item)
 		{
 			m_lastResult = std::forward<U>(item);
+			m_hasResult = true;
+		}
+
+		// other combined the results following this one's
+		void merge(LastCombiner &&other)
+		{
+			if (other.m_hasResult)
+			{
+				m_lastResult = std::move(other.m_lastResult);
+				m_hasResult = true;
+			}
 		}
 
 		result_type result()
@@ -66,6 +100,7 @@ namespace sig
 
 	private:
 		result_type m_lastResult;
+		bool m_hasResult = false;
 	};
 
 	template <>
@@ -99,12 +134,36 @@ namespace sig
 	public:
 		using result_type = std::vector<T>;
 
+		// Combiner for a new emission: collected results belong to one emission
+		VectorCombiner fresh() const
+		{
+			return VectorCombiner();
+		}
+
 		template <typename U>
 		void combine(U &&item)
 		{
 			m_all_results.emplace_back(std::forward<U>(item));
 		}
 
+		void reserve(std::size_t count)
+		{
+			m_all_results.reserve(count);
+		}
+
+		// other combined the results following this one's
+		void merge(VectorCombiner &&other)
+		{
+			if (m_all_results.empty())
+			{
+				m_all_results.swap(other.m_all_results);
+				return;
+			}
+			m_all_results.insert(m_all_results.end(),
+								 std::make_move_iterator(other.m_all_results.begin()),
+								 std::make_move_iterator(other.m_all_results.end()));
+		}
+
 		result_type result()
 		{
 			return std::move(m_all_results);
@@ -123,62 +182,3304 @@ namespace sig
 	};
 
 	/*******************************************************************************
-	 *                               Signal
+	 *                               SumCombiner
 	 *******************************************************************************/
 
-	template <typename Signature, typename Combiner = DiscardCombiner>
-	class Signal;
-
-	template <typename R, typename... Args, typename Combiner>
-	class Signal<R(Args...), Combiner>
+	// Adds up the results, starting from a value-initialized T
+	template <typename T>
+	class SumCombiner
 	{
+	public:
+		using result_type = T;
+
+		template <typename U>
+		void combine(U &&item)
+		{
+			m_sum += std::forward<U>(item);
+		}
+
+		void merge(SumCombiner &&other)
+		{
+			m_sum += std::move(other.m_sum);
+		}
+
+		result_type result()
+		{
+			return std::move(m_sum);
+		}
+
+	private:
+		result_type m_sum{};
+	};
 
+	/*******************************************************************************
+	 *                               MinCombiner
+	 *******************************************************************************/
+
+	// Smallest result, the first one on ties; empty without slots
+	template <typename T>
+	class MinCombiner
+	{
 	public:
-		using combiner_type = Combiner;
-		using result_type = typename Combiner::result_type;
-		using signature_type = R(Args...);
+		using result_type = std::optional<T>;
 
-		Signal(Combiner combiner = Combiner())
-			: m_combiner(std::move(combiner)), m_id(0)
+		template <typename U>
+		void combine(U &&item)
 		{
+			if (!m_min || item < *m_min)
+			{
+				m_min = std::forward<U>(item);
+			}
 		}
 
-		std::size_t connectSlot(std::function<signature_type> callback)
+		// other combined the results following this one's
+		void merge(MinCombiner &&other)
 		{
-			std::size_t id = m_id;
-			m_slots.emplace(id, callback);
-			m_id++;
-			return id;
+			if (other.m_min && (!m_min || *other.m_min < *m_min))
+			{
+				m_min = std::move(other.m_min);
+			}
 		}
 
-		void disconnectSlot(std::size_t id)
+		result_type result()
 		{
-			m_slots.erase(id);
+			return std::move(m_min);
 		}
 
-		result_type emitSignal(Args... args)
+	private:
+		result_type m_min;
+	};
+
+	/*******************************************************************************
+	 *                               MaxCombiner
+	 *******************************************************************************/
+
+	// Largest result, the first one on ties; empty without slots
+	template <typename T>
+	class MaxCombiner
+	{
+	public:
+		using result_type = std::optional<T>;
+
+		template <typename U>
+		void combine(U &&item)
 		{
-			if constexpr (std::is_void_v<result_type>)
+			if (!m_max || *m_max < item)
 			{
-				for (auto &slot : m_slots)
-				{
-					slot.second(std::forward<Args>(args)...);
-				}
+				m_max = std::forward<U>(item);
 			}
-			else
+		}
+
+		// other combined the results following this one's
+		void merge(MaxCombiner &&other)
+		{
+			if (other.m_max && (!m_max || *m_max < *other.m_max))
 			{
-				for (auto &slot : m_slots)
-				{
-					m_combiner.combine(slot.second(std::forward<Args>(args)...));
-				}
-				return m_combiner.result();
+				m_max = std::move(other.m_max);
+			}
+		}
+
+		result_type result()
+		{
+			return std::move(m_max);
+		}
+
+	private:
+		result_type m_max;
+	};
+
+	/*******************************************************************************
+	 *                               CountCombiner
+	 *******************************************************************************/
+
+	// Number of results, whatever their type
+	class CountCombiner
+	{
+	public:
+		using result_type = std::size_t;
+
+		template <typename U>
+		void combine(U &&)
+		{
+			++m_count;
+		}
+
+		void merge(CountCombiner &&other)
+		{
+			m_count += other.m_count;
+		}
+
+		result_type result()
+		{
+			return m_count;
+		}
+
+	private:
+		result_type m_count = 0;
+	};
+
+	/*******************************************************************************
+	 *                               FirstCombiner
+	 *******************************************************************************/
+
+	template <typename T>
+	class FirstCombinerBase
+	{
+		template <typename U>
+		void combine(U item)
+		{
+			// do nothing
+		}
+
+		void result()
+		{
+			// do nothing
+		}
+	};
+
+	template <typename T>
+	class FirstCombiner : public FirstCombinerBase<T>
+	{
+	public:
+		using result_type = T;
+
+		template <typename U>
+		Combine combine(U &&item)
+		{
+			m_firstResult = std::forward<U>(item);
+			return Combine::Stop;
+		}
+
+		result_type result()
+		{
+			return std::move(m_firstResult);
+		}
+
+	private:
+		result_type m_firstResult{};
+	};
+
+	template <>
+	class FirstCombiner<void> : public FirstCombinerBase<void>
+	{
+	public:
+		using result_type = void;
+	};
+
+	/*******************************************************************************
+	 *                               FirstMatchingCombiner
+	 *******************************************************************************/
+
+	// Keeps the first result satisfying the predicate, if any
+	template <typename T, typename Predicate>
+	class FirstMatchingCombiner
+	{
+	public:
+		using result_type = std::optional<T>;
+
+		FirstMatchingCombiner(Predicate predicate = Predicate())
+			: m_predicate(std::move(predicate))
+		{
+		}
+
+		template <typename U>
+		Combine combine(U &&item)
+		{
+			if (!std::invoke(m_predicate, std::as_const(item)))
+			{
+				return Combine::Continue;
 			}
+			m_match.emplace(std::forward<U>(item));
+			return Combine::Stop;
+		}
+
+		result_type result()
+		{
+			return std::move(m_match);
+		}
+
+	private:
+		Predicate m_predicate;
+		result_type m_match;
+	};
+
+	/*******************************************************************************
+	 *                               AnyOfCombiner
+	 *******************************************************************************/
+
+	// True as soon as one slot returns a true value
+	class AnyOfCombiner
+	{
+	public:
+		using result_type = bool;
+
+		template <typename U>
+		Combine combine(U &&item)
+		{
+			m_any = static_cast<bool>(item);
+			return m_any ? Combine::Stop : Combine::Continue;
+		}
+
+		result_type result()
+		{
+			return m_any;
+		}
+
+	private:
+		bool m_any = false;
+	};
+
+	/*******************************************************************************
+	 *                               AllOfCombiner
+	 *******************************************************************************/
+
+	// False as soon as one slot returns a false value
+	class AllOfCombiner
+	{
+	public:
+		using result_type = bool;
+
+		template <typename U>
+		Combine combine(U &&item)
+		{
+			m_all = static_cast<bool>(item);
+			return m_all ? Combine::Continue : Combine::Stop;
+		}
+
+		result_type result()
+		{
+			return m_all;
+		}
+
+	private:
+		bool m_all = true;
+	};
+
+	/*******************************************************************************
+	 *                               OutputCombiner
+	 *******************************************************************************/
+
+	// Writes every result through an output iterator and returns the iterator
+	// past the last written result.
+	template <typename OutputIt>
+	class OutputCombiner
+	{
+	public:
+		using result_type = OutputIt;
+
+		OutputCombiner(OutputIt out = OutputIt())
+			: m_out(out)
+		{
+		}
+
+		template <typename U>
+		void combine(U &&item)
+		{
+			*m_out = std::forward<U>(item);
+			++m_out;
+		}
+
+		result_type result()
+		{
+			return m_out;
 		}
 
 	private:
+		OutputIt m_out;
+	};
+
+	/*******************************************************************************
+	 *                               Combiner construction
+	 *******************************************************************************/
+
+	// Feeds a result to the combiner and tells whether the remaining slots
+	// should still be invoked
+	template <typename Combiner, typename U>
+	bool combineItem(Combiner &combiner, U &&item)
+	{
+		if constexpr (std::is_same_v<decltype(combiner.combine(std::forward<U>(item))), Combine>)
+		{
+			return combiner.combine(std::forward<U>(item)) == Combine::Continue;
+		}
+		else
+		{
+			combiner.combine(std::forward<U>(item));
+			return true;
+		}
+	}
+
+	template <typename Combiner, typename = void>
+	struct hasReserve : std::false_type
+	{
+	};
+
+	template <typename Combiner>
+	struct hasReserve<Combiner, std::void_t<decltype(std::declval<Combiner &>().reserve(std::size_t()))>> : std::true_type
+	{
+	};
+
+	// Mergeable combiners provide merge(Combiner &&other), folding in a
+	// combiner that received the results following this one's. The operation
+	// must be associative, so partial results can be combined independently.
+	template <typename Combiner, typename = void>
+	struct hasMerge : std::false_type
+	{
+	};
+
+	template <typename Combiner>
+	struct hasMerge<Combiner, std::void_t<decltype(std::declval<Combiner &>().merge(std::declval<Combiner &&>()))>> : std::true_type
+	{
+	};
+
+	// Combiners holding per-emission state provide fresh(), returning a
+	// combiner with the same configuration and none of that state, so that
+	// copying them stays a real copy.
+	template <typename Combiner, typename = void>
+	struct hasFresh : std::false_type
+	{
+	};
+
+	template <typename Combiner>
+	struct hasFresh<Combiner, std::enable_if_t<std::is_same_v<decltype(std::declval<const Combiner &>().fresh()), Combiner>>> : std::true_type
+	{
+	};
+
+	// Combiner configured like prototype: its fresh() when it has one, else a
+	// copy, else a default-constructed one
+	template <typename Combiner>
+	Combiner freshCombiner(const Combiner &prototype)
+	{
+		if constexpr (hasFresh<Combiner>::value)
+		{
+			return prototype.fresh();
+		}
+		else if constexpr (std::is_copy_constructible_v<Combiner>)
+		{
+			return prototype;
+		}
+		else
+		{
+			return Combiner();
+		}
+	}
+
+	// Every emission combines into its own fresh copy of the signal's
+	// combiner, so no state leaks between emissions and nested emissions do
+	// not interfere. Combiners that provide reserve() are told how many slots
+	// will report.
+	template <typename Combiner>
+	Combiner makeCombiner(const Combiner &prototype, std::size_t slotCount)
+	{
+		Combiner combiner = freshCombiner(prototype);
+		if constexpr (hasReserve<Combiner>::value)
+		{
+			combiner.reserve(slotCount);
+		}
+		return combiner;
+	}
+
+	/*******************************************************************************
+	 *                               Argument passing
+	 *******************************************************************************/
+
+	// How an emitted argument reaches the slots. References and cheap values are
+	// passed as they are. Other values are shared as const references by every
+	// slot but the last one, which may receive them as rvalues. Values that
+	// cannot be copied are shared by every slot: one slot owning such a value
+	// would leave the others a moved-from one.
+	template <typename T>
+	constexpr bool isCheapArgument = std::is_trivially_copyable_v<T> && std::is_copy_constructible_v<T> && sizeof(T) <= 2 * sizeof(void *);
+
+	template <typename T>
+	using shared_argument_t = std::conditional_t<std::is_reference_v<T> || isCheapArgument<T>, T, const T &>;
+
+	template <typename T>
+	using last_argument_t = std::conditional_t<std::is_reference_v<T> || isCheapArgument<T>, T,
+											   std::conditional_t<std::is_copy_constructible_v<T>, T &&, const T &>>;
+
+	// Parameter a slot is checked against: copyable values may be taken any
+	// way, the slot getting a copy when it needs one
+	template <typename T>
+	using unique_parameter_t = std::conditional_t<std::is_reference_v<T> || std::is_copy_constructible_v<T>, T, const T &>;
+
+	template <typename R, typename F, typename... Args>
+	constexpr bool takesUniqueArguments = std::is_invocable_r_v<R, F, unique_parameter_t<Args>...>;
+
+	template <typename... Args>
+	constexpr bool hasMovedArguments = (!std::is_same_v<shared_argument_t<Args>, last_argument_t<Args>> || ...);
+
+	// The last slot takes the rvalue path when the caller gave up one of the
+	// arguments that path would move.
+	template <typename Signature, typename... EmitArgs>
+	constexpr bool movesToLastSlot = false;
+
+	template <typename R, typename... Args, typename... EmitArgs>
+	constexpr bool movesToLastSlot<R(Args...), EmitArgs...> =
+		((!std::is_same_v<shared_argument_t<Args>, last_argument_t<Args>> && !std::is_lvalue_reference_v<EmitArgs>) || ...);
+
+	// A non-const lvalue reference parameter lets slots modify the caller's
+	// object: it binds an lvalue of its type, or of a derived type, only.
+	template <typename T, typename EmitArg>
+	constexpr bool bindsArgument = !std::is_lvalue_reference_v<T> || std::is_const_v<std::remove_reference_t<T>> ||
+								   (std::is_lvalue_reference_v<EmitArg> && std::is_convertible_v<std::remove_reference_t<EmitArg> *, std::remove_reference_t<T> *>);
+
+	// Converts an emitted argument to its signature type once per emission.
+	// Arguments that already have that type are forwarded untouched.
+	template <typename T, typename EmitArg>
+	decltype(auto) adaptArgument(EmitArg &&arg)
+	{
+		static_assert(bindsArgument<T, EmitArg>, "a non-const reference parameter needs an lvalue of its type");
+		using Value = std::remove_cv_t<std::remove_reference_t<T>>;
+		if constexpr (std::is_same_v<std::decay_t<EmitArg>, Value> || (std::is_reference_v<T> && std::is_base_of_v<Value, std::decay_t<EmitArg>>))
+		{
+			return std::forward<EmitArg>(arg);
+		}
+		else
+		{
+			return Value(std::forward<EmitArg>(arg));
+		}
+	}
+
+	template <typename T, typename EmitArg>
+	decltype(auto) sharedArgument(std::remove_reference_t<EmitArg> &arg)
+	{
+		return static_cast<shared_argument_t<T>>(arg);
+	}
+
+	// An argument the caller still owns is copied for the last slot
+	template <typename T, typename EmitArg>
+	decltype(auto) lastArgument(std::remove_reference_t<EmitArg> &arg)
+	{
+		if constexpr (std::is_same_v<shared_argument_t<T>, last_argument_t<T>>)
+		{
+			return static_cast<shared_argument_t<T>>(arg);
+		}
+		else if constexpr (std::is_lvalue_reference_v<EmitArg>)
+		{
+			return T(arg);
+		}
+		else
+		{
+			return static_cast<T &&>(arg);
+		}
+	}
+
+	// A slot taking an rvalue cannot bind a shared const reference: give it a copy
+	template <typename T, typename Param>
+	decltype(auto) rvalueArgument(std::remove_reference_t<Param> &param)
+	{
+		if constexpr (!std::is_reference_v<T> && std::is_same_v<Param, const T &>)
+		{
+			return T(param);
+		}
+		else
+		{
+			return static_cast<Param &&>(param);
+		}
+	}
+
+	/*******************************************************************************
+	 *                               SlotFunction
+	 *******************************************************************************/
+
+	constexpr std::size_t defaultSlotBufferSize = 4 * sizeof(void *);
+
+	// Move-only callable wrapper. Callables that fit in BufferSize bytes and
+	// can be moved without throwing are stored inline, larger ones on the heap.
+	template <typename Signature, std::size_t BufferSize = defaultSlotBufferSize>
+	class SlotFunction;
+
+	template <typename R, typename... Args, std::size_t BufferSize>
+	class SlotFunction<R(Args...), BufferSize>
+	{
+	public:
+		SlotFunction() noexcept = default;
+
+		template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, SlotFunction>>>
+		SlotFunction(F &&f)
+		{
+			emplace<std::decay_t<F>>(std::forward<F>(f));
+		}
+
+		template <typename F, typename... CtorArgs>
+		explicit SlotFunction(std::in_place_type_t<F>, CtorArgs &&...ctorArgs)
+		{
+			emplace<F>(std::forward<CtorArgs>(ctorArgs)...);
+		}
+
+		SlotFunction(SlotFunction &&other) noexcept
+		{
+			moveFrom(other);
+		}
+
+		SlotFunction &operator=(SlotFunction &&other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				moveFrom(other);
+			}
+			return *this;
+		}
+
+		SlotFunction(const SlotFunction &) = delete;
+		SlotFunction &operator=(const SlotFunction &) = delete;
+
+		~SlotFunction()
+		{
+			reset();
+		}
+
+		explicit operator bool() const noexcept
+		{
+			return m_invokers.shared != nullptr;
+		}
+
+		R operator()(Args... args)
+		{
+			return invokeLast(static_cast<last_argument_t<Args>>(args)...);
+		}
+
+		// Call used for every slot of an emission but the last one
+		R invoke(shared_argument_t<Args>... args)
+		{
+			return m_invokers.shared(m_storage, static_cast<shared_argument_t<Args>>(args)...);
+		}
+
+		// Call used for the last slot, which may consume rvalue arguments
+		R invokeLast(last_argument_t<Args>... args)
+		{
+			if constexpr (hasMovedArguments<Args...>)
+			{
+				return m_invokers.last(m_storage, static_cast<last_argument_t<Args>>(args)...);
+			}
+			else
+			{
+				return m_invokers.shared(m_storage, static_cast<last_argument_t<Args>>(args)...);
+			}
+		}
+
+		void reset() noexcept
+		{
+			if (m_manage)
+			{
+				m_manage(Operation::Destroy, m_storage, nullptr);
+			}
+			m_invokers = Invokers();
+			m_manage = nullptr;
+		}
+
+		// Delegates: the target is a template argument, so the slot is only the
+		// invoker and an object pointer, with no manager and a single indirect call.
+		template <auto Function>
+		static SlotFunction bind()
+		{
+			static_assert(std::is_invocable_r_v<R, decltype(Function), Args...>, "slot is not callable with the signal signature");
+			static_assert(takesUniqueArguments<R, decltype(Function), Args...>, "slots take the arguments that cannot be copied by const reference");
+			SlotFunction function;
+			function.template setInvokers<FunctionTarget<Function>>();
+			return function;
+		}
+
+		template <auto Method, typename T>
+		static SlotFunction bind(T *object)
+		{
+			static_assert(std::is_member_function_pointer_v<decltype(Method)>, "delegate target is not a member function");
+			static_assert(std::is_invocable_r_v<R, decltype(Method), T *, Args...>, "slot is not callable with the signal signature");
+			static_assert(takesUniqueArguments<R, decltype(Method), T *, Args...>, "slots take the arguments that cannot be copied by const reference");
+			SlotFunction function;
+			function.m_storage.object = const_cast<void *>(static_cast<const void *>(object));
+			function.template setInvokers<MethodTarget<Method, T>>();
+			return function;
+		}
+
+		// Slot calling target, whose storage target keeps alive. references
+		// counts the holders of target, this slot included: the last one to
+		// let go destroys it.
+		static SlotFunction share(std::shared_ptr<SlotFunction> target, std::atomic<std::uint32_t> &references)
+		{
+			SlotFunction function;
+			function.template construct<SharedTarget>(std::move(target), &references);
+			function.m_invokers.shared = &invokeShared;
+			if constexpr (hasMovedArguments<Args...>)
+			{
+				function.m_invokers.last = &invokeSharedLast;
+			}
+			return function;
+		}
+
+		bool isShared() const
+		{
+			return m_invokers.shared == &invokeShared;
+		}
+
+		// Another slot sharing the target of this shared slot
+		SlotFunction shareTarget()
+		{
+			SharedTarget &shared = SharedAccess::get(m_storage);
+			shared.references->fetch_add(1, std::memory_order_relaxed);
+			return share(shared.target, *shared.references);
+		}
+
+		// Takes the target back once no one else holds it
+		bool unshare()
+		{
+			SharedTarget &shared = SharedAccess::get(m_storage);
+			// the other holders may have let go on other threads
+			if (shared.references->load(std::memory_order_acquire) != 1)
+			{
+				return false;
+			}
+			SlotFunction owned(std::move(*shared.target));
+			shared.references = nullptr;
+			*this = std::move(owned);
+			return true;
+		}
+
+		template <typename F>
+		static constexpr bool storedInline()
+		{
+			return sizeof(F) <= BufferSize
+				&& alignof(F) <= alignof(Storage)
+				&& std::is_nothrow_move_constructible_v<F>;
+		}
+
+	private:
+		union Storage
+		{
+			void *object;
+			alignas(std::max_align_t) unsigned char buffer[BufferSize];
+		};
+
+		enum class Operation
+		{
+			Move,
+			Destroy
+		};
+
+		using SharedInvoke = R (*)(Storage &, shared_argument_t<Args>...);
+		using LastInvoke = R (*)(Storage &, last_argument_t<Args>...);
+		using Manage = void (*)(Operation, Storage &, Storage *);
+
+		struct SharedInvoker
+		{
+			SharedInvoke shared = nullptr;
+		};
+
+		struct SharedAndLastInvokers
+		{
+			SharedInvoke shared = nullptr;
+			LastInvoke last = nullptr;
+		};
+
+		using Invokers = std::conditional_t<hasMovedArguments<Args...>, SharedAndLastInvokers, SharedInvoker>;
+
+		template <typename F>
+		struct InlineTarget
+		{
+			static F &get(Storage &storage)
+			{
+				return *std::launder(reinterpret_cast<F *>(storage.buffer));
+			}
+		};
+
+		template <typename F>
+		struct HeapTarget
+		{
+			static F &get(Storage &storage)
+			{
+				return *static_cast<F *>(storage.object);
+			}
+		};
+
+		template <auto Function>
+		struct FunctionTarget
+		{
+			static decltype(Function) get(Storage &)
+			{
+				return Function;
+			}
+		};
+
+		template <auto Method, typename T>
+		struct MethodTarget
+		{
+			struct Bound
+			{
+				template <typename... CallArgs>
+				auto operator()(CallArgs &&...callArgs) const -> decltype(std::invoke(Method, std::declval<T *>(), std::forward<CallArgs>(callArgs)...))
+				{
+					return std::invoke(Method, object, std::forward<CallArgs>(callArgs)...);
+				}
+
+				T *object;
+			};
+
+			static Bound get(Storage &storage)
+			{
+				return Bound{static_cast<T *>(storage.object)};
+			}
+		};
+
+		template <typename F, typename... CtorArgs>
+		void emplace(CtorArgs &&...ctorArgs)
+		{
+			static_assert(std::is_invocable_r_v<R, F &, Args...>, "slot is not callable with the signal signature");
+			static_assert(takesUniqueArguments<R, F &, Args...>, "slots take the arguments that cannot be copied by const reference");
+
+			construct<F>(std::forward<CtorArgs>(ctorArgs)...);
+			setInvokers<StorageTarget<F>>();
+		}
+
+		template <typename F>
+		using StorageTarget = std::conditional_t<storedInline<F>(), InlineTarget<F>, HeapTarget<F>>;
+
+		// Stores F, without the invokers
+		template <typename F, typename... CtorArgs>
+		void construct(CtorArgs &&...ctorArgs)
+		{
+			if constexpr (storedInline<F>())
+			{
+				::new (static_cast<void *>(m_storage.buffer)) F(std::forward<CtorArgs>(ctorArgs)...);
+				if constexpr (!std::is_trivially_copyable_v<F>)
+				{
+					m_manage = &manageInline<F>;
+				}
+			}
+			else
+			{
+				m_storage.object = new F(std::forward<CtorArgs>(ctorArgs)...);
+				m_manage = &manageHeap<F>;
+			}
+		}
+
+		template <typename Target>
+		void setInvokers()
+		{
+			m_invokers.shared = &invokeTarget<Target, shared_argument_t<Args>...>;
+			if constexpr (hasMovedArguments<Args...>)
+			{
+				m_invokers.last = &invokeTarget<Target, last_argument_t<Args>...>;
+			}
+		}
+
+		// trivially copyable inline callables have no manager and are moved bytewise
+		void moveFrom(SlotFunction &other) noexcept
+		{
+			if (other.m_manage)
+			{
+				other.m_manage(Operation::Move, other.m_storage, &m_storage);
+			}
+			else
+			{
+				std::memcpy(&m_storage, &other.m_storage, sizeof(Storage));
+			}
+			m_invokers = other.m_invokers;
+			m_manage = other.m_manage;
+			other.m_invokers = Invokers();
+			other.m_manage = nullptr;
+		}
+
+		template <typename F, typename... CallArgs>
+		static R call(F &&f, CallArgs &&...callArgs)
+		{
+			if constexpr (std::is_void_v<R>)
+			{
+				std::invoke(std::forward<F>(f), std::forward<CallArgs>(callArgs)...);
+			}
+			else
+			{
+				return std::invoke(std::forward<F>(f), std::forward<CallArgs>(callArgs)...);
+			}
+		}
+
+		struct SharedTarget
+		{
+			SharedTarget(std::shared_ptr<SlotFunction> sharedTarget, std::atomic<std::uint32_t> *count) noexcept
+				: target(std::move(sharedTarget)), references(count)
+			{
+			}
+
+			SharedTarget(SharedTarget &&other) noexcept
+				: target(std::move(other.target)), references(std::exchange(other.references, nullptr))
+			{
+			}
+
+			~SharedTarget()
+			{
+				if (references && references->fetch_sub(1, std::memory_order_acq_rel) == 1)
+				{
+					*target = SlotFunction();
+				}
+			}
+
+			std::shared_ptr<SlotFunction> target;
+			std::atomic<std::uint32_t> *references;
+		};
+
+		using SharedAccess = StorageTarget<SharedTarget>;
+
+		static R invokeShared(Storage &storage, shared_argument_t<Args>... args)
+		{
+			return SharedAccess::get(storage).target->invoke(static_cast<shared_argument_t<Args>>(args)...);
+		}
+
+		static R invokeSharedLast(Storage &storage, last_argument_t<Args>... args)
+		{
+			return SharedAccess::get(storage).target->invokeLast(static_cast<last_argument_t<Args>>(args)...);
+		}
+
+		template <typename Target, typename... Params>
+		static R invokeTarget(Storage &storage, Params... params)
+		{
+			auto &&target = Target::get(storage);
+			if constexpr (std::is_invocable_r_v<R, decltype((target)), Params...>)
+			{
+				return call(target, static_cast<Params &&>(params)...);
+			}
+			else
+			{
+				return call(target, rvalueArgument<Args, Params>(params)...);
+			}
+		}
+
+		template <typename F>
+		static void manageInline(Operation operation, Storage &storage, Storage *destination)
+		{
+			F *f = std::launder(reinterpret_cast<F *>(storage.buffer));
+			if (operation == Operation::Move)
+			{
+				::new (static_cast<void *>(destination->buffer)) F(std::move(*f));
+			}
+			f->~F();
+		}
+
+		template <typename F>
+		static void manageHeap(Operation operation, Storage &storage, Storage *destination)
+		{
+			if (operation == Operation::Move)
+			{
+				destination->object = storage.object;
+			}
+			else
+			{
+				delete static_cast<F *>(storage.object);
+			}
+		}
+
+		Invokers m_invokers;
+		Manage m_manage = nullptr;
+		Storage m_storage;
+	};
+
+	/*******************************************************************************
+	 *                               SlotInvocation
+	 *******************************************************************************/
+
+	// Invocation of one slot during an emission, shared by the signal types.
+	// Non-void results go to sink, which returns false to stop the emission.
+	template <typename Signature, typename... EmitArgs>
+	struct SlotInvocation;
+
+	template <typename R, typename... Args, typename... EmitArgs>
+	struct SlotInvocation<R(Args...), EmitArgs...>
+	{
+		template <typename Slot, typename Sink>
+		static bool invoke(Slot &slot, Sink &sink, std::remove_reference_t<EmitArgs> &...args)
+		{
+			if constexpr (std::is_void_v<R>)
+			{
+				slot.invoke(sharedArgument<Args, EmitArgs>(args)...);
+				return true;
+			}
+			else
+			{
+				return sink(slot.invoke(sharedArgument<Args, EmitArgs>(args)...));
+			}
+		}
+
+		template <typename Slot, typename Sink>
+		static bool invokeLast(Slot &slot, Sink &sink, std::remove_reference_t<EmitArgs> &...args)
+		{
+			if constexpr (!movesToLastSlot<R(Args...), EmitArgs...>)
+			{
+				return invoke(slot, sink, args...);
+			}
+			else if constexpr (std::is_void_v<R>)
+			{
+				slot.invokeLast(lastArgument<Args, EmitArgs>(args)...);
+				return true;
+			}
+			else
+			{
+				return sink(slot.invokeLast(lastArgument<Args, EmitArgs>(args)...));
+			}
+		}
+	};
+
+	/*******************************************************************************
+	 *                               EmissionTracker
+	 *******************************************************************************/
+
+	// Completion of an emission whose slots may finish elsewhere. While an
+	// emission runs under a tracker, like in Signal::emitAsync, the tracker is
+	// current for the emitting thread and work handed to other threads holds
+	// it open until done.
+	class EmissionTracker
+	{
+	public:
+		// Keeps a tracker open while alive, released when destroyed. Copies
+		// hold it too, so tasks stay copyable for std::function executors.
+		class Hold
+		{
+		public:
+			explicit Hold(EmissionTracker *tracker) noexcept
+				: m_tracker(tracker)
+			{
+				retain();
+			}
+
+			Hold(const Hold &other) noexcept
+				: m_tracker(other.m_tracker)
+			{
+				retain();
+			}
+
+			Hold(Hold &&other) noexcept
+				: m_tracker(std::exchange(other.m_tracker, nullptr))
+			{
+			}
+
+			Hold &operator=(const Hold &) = delete;
+
+			~Hold()
+			{
+				if (m_tracker)
+				{
+					m_tracker->m_release(m_tracker);
+				}
+			}
+
+		private:
+			void retain() noexcept
+			{
+				if (m_tracker)
+				{
+					m_tracker->m_retain(m_tracker);
+				}
+			}
+
+			EmissionTracker *m_tracker;
+		};
+
+		static EmissionTracker *&current() noexcept
+		{
+			thread_local EmissionTracker *tracker = nullptr;
+			return tracker;
+		}
+
+	protected:
+		using Notify = void (*)(EmissionTracker *);
+
+		EmissionTracker(Notify retain, Notify release) noexcept
+			: m_retain(retain), m_release(release)
+		{
+		}
+
+	private:
+		Notify m_retain;
+		Notify m_release;
+	};
+
+	// Defined in Future.h
+	template <typename T>
+	class Future;
+
+	template <typename T>
+	class Promise;
+
+	// Observer of the next emission of a signal, registered by awaiting
+	// Signal::next(). The emission hands it copies of the arguments before
+	// calling the slots and resumes it once they have run. signal is the
+	// signal it is registered with, which keeps it up to date when moved.
+	template <typename... Args>
+	struct NextWaiter
+	{
+		NextWaiter *next = nullptr;
+		void *signal = nullptr;
+		void (*receive)(NextWaiter *, shared_argument_t<Args>...) = nullptr;
+		void (*resume)(NextWaiter *) = nullptr;
+	};
+
+	// Defined in SignalCoro.h
+	template <typename SignalType>
+	class NextEmission;
+
+	/*******************************************************************************
+	 *                               Queued slots
+	 *******************************************************************************/
+
+	// Slot delivering emissions to executor instead of calling callback
+	// directly: each emission copies the arguments into a task given to
+	// executor.post, and callback runs on the thread draining the executor.
+	// The callback is shared with the pending tasks, so it outlives a
+	// disconnect; the executor must outlive the connection. Tasks hold the
+	// emission tracker current when posted until they have run.
+	template <typename Signature>
+	struct QueuedSlot;
+
+	template <typename R, typename... Args>
+	struct QueuedSlot<R(Args...)>
+	{
+		static_assert(std::is_void_v<R>, "Queued slots cannot return a result");
+		static_assert(!(... || (std::is_lvalue_reference_v<Args> && !std::is_const_v<std::remove_reference_t<Args>>)),
+					  "Queued slots cannot take non-const references");
+
+		template <typename Executor, typename F>
+		static auto make(Executor &executor, F &&callback)
+		{
+			auto shared = std::make_shared<std::decay_t<F>>(std::forward<F>(callback));
+			return [&executor, shared = std::move(shared)](auto &&...args)
+			{
+				executor.post([shared, hold = EmissionTracker::Hold(EmissionTracker::current()),
+							   arguments = std::tuple<std::decay_t<Args>...>(std::forward<decltype(args)>(args)...)]() mutable
+							  { std::apply(*shared, std::move(arguments)); });
+			};
+		}
+	};
+
+	template <typename Signature, typename Executor, typename F>
+	auto queuedSlot(Executor &executor, F &&callback)
+	{
+		return QueuedSlot<Signature>::make(executor, std::forward<F>(callback));
+	}
+
+	/*******************************************************************************
+	 *                               SmallVector
+	 *******************************************************************************/
+
+	// Vector whose first N elements live inside the object, so it only
+	// allocates once it grows past them.
+	template <typename T, std::size_t N>
+	class SmallVector
+	{
+		static_assert(N > 0, "SmallVector needs at least one inline element");
+		static_assert(std::is_nothrow_move_constructible_v<T>, "SmallVector elements must be nothrow movable");
+
+	public:
+		SmallVector() noexcept
+			: m_data(inlineData())
+		{
+		}
+
+		SmallVector(SmallVector &&other) noexcept
+			: m_data(inlineData())
+		{
+			moveFrom(other);
+		}
+
+		SmallVector &operator=(SmallVector &&other) noexcept
+		{
+			if (this != &other)
+			{
+				clear();
+				releaseHeap();
+				moveFrom(other);
+			}
+			return *this;
+		}
+
+		~SmallVector()
+		{
+			clear();
+			releaseHeap();
+		}
+
+		T *begin() { return m_data; }
+		T *end() { return m_data + m_size; }
+		const T *begin() const { return m_data; }
+		const T *end() const { return m_data + m_size; }
+
+		T &operator[](std::size_t i) { return m_data[i]; }
+		const T &operator[](std::size_t i) const { return m_data[i]; }
+		T &back() { return m_data[m_size - 1]; }
+
+		std::size_t size() const { return m_size; }
+		std::size_t capacity() const { return m_capacity; }
+		bool empty() const { return m_size == 0; }
+
+		template <typename... ElementArgs>
+		T &emplace_back(ElementArgs &&...elementArgs)
+		{
+			if (m_size == m_capacity)
+			{
+				grow(m_capacity < 4 ? 4 : 2 * m_capacity);
+			}
+			T *element = ::new (static_cast<void *>(m_data + m_size)) T(std::forward<ElementArgs>(elementArgs)...);
+			++m_size;
+			return *element;
+		}
+
+		void pop_back()
+		{
+			m_data[--m_size].~T();
+		}
+
+		void truncate(std::size_t size)
+		{
+			while (m_size > size)
+			{
+				pop_back();
+			}
+		}
+
+		void clear()
+		{
+			truncate(0);
+		}
+
+		void reserve(std::size_t capacity)
+		{
+			if (capacity > m_capacity)
+			{
+				grow(capacity);
+			}
+		}
+
+	private:
+		T *inlineData()
+		{
+			return reinterpret_cast<T *>(m_inline);
+		}
+
+		bool isInline()
+		{
+			return m_data == inlineData();
+		}
+
+		void grow(std::size_t capacity)
+		{
+			T *data = std::allocator<T>().allocate(capacity);
+			for (std::uint32_t i = 0; i < m_size; ++i)
+			{
+				::new (static_cast<void *>(data + i)) T(std::move(m_data[i]));
+				m_data[i].~T();
+			}
+			releaseHeap();
+			m_data = data;
+			m_capacity = static_cast<std::uint32_t>(capacity);
+		}
+
+		void releaseHeap()
+		{
+			if (!isInline())
+			{
+				std::allocator<T>().deallocate(m_data, m_capacity);
+				m_data = inlineData();
+				m_capacity = N;
+			}
+		}
+
+		void moveFrom(SmallVector &other)
+		{
+			if (other.isInline())
+			{
+				for (std::uint32_t i = 0; i < other.m_size; ++i)
+				{
+					::new (static_cast<void *>(m_data + i)) T(std::move(other.m_data[i]));
+				}
+				m_size = other.m_size;
+				other.clear();
+			}
+			else
+			{
+				m_data = other.m_data;
+				m_size = other.m_size;
+				m_capacity = other.m_capacity;
+				other.m_data = other.inlineData();
+				other.m_size = 0;
+				other.m_capacity = N;
+			}
+		}
+
+		T *m_data;
+		std::uint32_t m_size = 0;
+		std::uint32_t m_capacity = N;
+		alignas(T) unsigned char m_inline[N * sizeof(T)];
+	};
+
+	/*******************************************************************************
+	 *                               SlotTable
+	 *******************************************************************************/
+
+	// Slots are kept contiguous and in connection order. An id packs the index
+	// of an entry in a sparse table with the generation of that entry, so a
+	// disconnected id can never reach a slot connected later. The first slot is
+	// stored inline: empty and single-slot tables never allocate.
+	//
+	// While an EmissionScope is open, the cells do not move: erased slots are
+	// only skipped, and destroyed once the outermost scope closes, and new
+	// slots wait in a pending list until then. Slots may thus connect and
+	// disconnect, themselves included, while they are being invoked.
+	//
+	// Tracked slots carry a flag in their cell index, so untracked slots pay
+	// nothing for tracking: the liveness test they already go through also
+	// sends tracked ones to the slower path, which locks their objects for
+	// the call. Slots found expired are erased in batches, once they make up
+	// a quarter of the table. Iterators given a KeepAlive lock the objects of
+	// the slot they reach.
+	//
+	// A bitmask beside the cells has a bit set for every live, unblocked
+	// slot. Emissions find the slots to call by scanning its set bits, so
+	// erased and blocked cells cost nothing, 64 at a time.
+	//
+	// Slots are move-only, so copies of a table share it copy-on-write:
+	// share() moves the table, as it is, into a reference-counted frozen
+	// table, and the original and the copy both read that one. The first
+	// change to either gives it cells of its own, calling the frozen slots
+	// through a count of the tables still holding each, so a slot is
+	// destroyed once no table calls it. A table left alone with the frozen
+	// table takes it back at its next change or emission, and one left alone
+	// with a frozen slot takes that slot back within as many changes and
+	// emissions as it has cells.
+	template <typename Slot>
+	class SlotTable
+	{
+		struct Cell;
+		struct Shared;
+
+	public:
+		SlotTable() = default;
+
+		// The moved-from table is left empty, ready for new slots. Tables are
+		// not moved during an emission.
+		SlotTable(SlotTable &&other) noexcept
+			: m_cells(std::move(other.m_cells)),
+			  m_enabled(std::move(other.m_enabled)),
+			  m_entries(std::move(other.m_entries)),
+			  m_pending(std::exchange(other.m_pending, {})),
+			  m_tracking(std::exchange(other.m_tracking, {})),
+			  m_shared(std::move(other.m_shared)),
+			  m_freeEntry(std::exchange(other.m_freeEntry, npos)),
+			  m_live(std::exchange(other.m_live, 0)),
+			  m_expired(std::exchange(other.m_expired, 0)),
+			  m_sharedCells(std::exchange(other.m_sharedCells, 0)),
+			  m_changes(std::exchange(other.m_changes, 0)),
+			  m_emitting(std::exchange(other.m_emitting, 0)),
+			  m_deferredErase(std::exchange(other.m_deferredErase, false))
+		{
+		}
+
+		SlotTable &operator=(SlotTable &&other) noexcept
+		{
+			if (this != &other)
+			{
+				leaveShared();
+				m_shared = std::move(other.m_shared);
+				m_cells = std::move(other.m_cells);
+				m_enabled = std::move(other.m_enabled);
+				m_entries = std::move(other.m_entries);
+				m_pending = std::exchange(other.m_pending, {});
+				m_tracking = std::exchange(other.m_tracking, {});
+				m_freeEntry = std::exchange(other.m_freeEntry, npos);
+				m_live = std::exchange(other.m_live, 0);
+				m_expired = std::exchange(other.m_expired, 0);
+				m_sharedCells = std::exchange(other.m_sharedCells, 0);
+				m_changes = std::exchange(other.m_changes, 0);
+				m_emitting = std::exchange(other.m_emitting, 0);
+				m_deferredErase = std::exchange(other.m_deferredErase, false);
+			}
+			return *this;
+		}
+
+		~SlotTable()
+		{
+			leaveShared();
+		}
+
+		// Marks an emission in progress for its lifetime; scopes nest
+		class EmissionScope
+		{
+		public:
+			explicit EmissionScope(SlotTable &table) noexcept
+				: m_table(table)
+			{
+				if (m_table.m_emitting == 0)
+				{
+					m_table.reclaimIdle();
+				}
+				++m_table.m_emitting;
+			}
+
+			EmissionScope(const EmissionScope &) = delete;
+			EmissionScope &operator=(const EmissionScope &) = delete;
+
+			~EmissionScope()
+			{
+				if (--m_table.m_emitting != 0)
+				{
+					return;
+				}
+				if (m_table.m_retired)
+				{
+					leave(*m_table.m_retired);
+					m_table.m_retired.reset();
+				}
+				if (m_table.m_deferredErase || !m_table.m_pending.empty() || m_table.sweepDue())
+				{
+					m_table.applyDeferred();
+				}
+			}
+
+		private:
+			SlotTable &m_table;
+		};
+
+		template <typename... SlotArgs>
+		std::size_t emplace(SlotArgs &&...slotArgs)
+		{
+			return insert(0, std::forward<SlotArgs>(slotArgs)...);
+		}
+
+		// The slot is skipped from the moment one of objects has expired
+		template <typename... SlotArgs>
+		std::size_t emplaceTracked(std::vector<std::weak_ptr<void>> objects, SlotArgs &&...slotArgs)
+		{
+			own();
+			if (m_tracking.size() <= m_entries.size())
+			{
+				m_tracking.resize(m_entries.size() + 1);
+			}
+			std::size_t id = insert(trackedBit, std::forward<SlotArgs>(slotArgs)...);
+			m_tracking[indexOf(id)] = Tracking{std::move(objects), false};
+			return id;
+		}
+
+		bool erase(std::size_t id)
+		{
+			if (!contains(id))
+			{
+				return false;
+			}
+			own();
+			eraseEntry(indexOf(id));
+			if (m_emitting == 0)
+			{
+				trim();
+			}
+			return true;
+		}
+
+		// Erases, in one pass, the slots whose id satisfies pred. They are
+		// destroyed once the pass is over, so pred may connect or disconnect
+		// slots itself. Slots connected by pred are not passed to it.
+		template <typename Predicate>
+		std::size_t eraseIf(Predicate &pred)
+		{
+			own();
+			EmissionScope scope(*this);
+			std::size_t erased = 0;
+			for (std::size_t position = 0, count = m_cells.size(); position < count; ++position)
+			{
+				erased += eraseCellIf(m_cells[position], pred);
+			}
+			for (std::size_t position = 0, count = m_pending.size(); position < count; ++position)
+			{
+				erased += eraseCellIf(m_pending[position], pred);
+			}
+			return erased;
+		}
+
+		// Copy calling the same slots, with the same ids, blocked and tracked
+		// slots: both tables read the same frozen table until one of them
+		// changes. Not to be used during an emission.
+		SlotTable share()
+		{
+			if (m_shared)
+			{
+				m_shared->readers.fetch_add(1, std::memory_order_relaxed);
+			}
+			else
+			{
+				freeze();
+			}
+			SlotTable copy;
+			copy.m_shared = m_shared;
+			return copy;
+		}
+
+		// Room for count more slots, in the pending list during an emission
+		void reserve(std::size_t count)
+		{
+			own();
+			m_entries.reserve(m_entries.size() + count);
+			if (m_emitting == 0)
+			{
+				m_cells.reserve(m_cells.size() + count);
+				m_enabled.reserve((m_cells.size() + count + wordBits - 1) / wordBits);
+			}
+			else
+			{
+				m_pending.reserve(m_pending.size() + count);
+			}
+		}
+
+		// Blocked slots keep their place and id but are skipped by emissions
+		bool setBlocked(std::size_t id, bool blocked)
+		{
+			if (!contains(id))
+			{
+				return false;
+			}
+			own();
+			std::uint32_t position = m_entries[indexOf(id)].position;
+			Cell &cell = (position & pendingBit) ? m_pending[position & ~pendingBit] : m_cells[position];
+			cell.index = blocked ? (cell.index | blockedBit) : (cell.index & ~blockedBit);
+			if (!(position & pendingBit))
+			{
+				setEnabled(position, !blocked);
+			}
+			return true;
+		}
+
+		bool isBlocked(std::size_t id) const
+		{
+			if (m_shared)
+			{
+				return m_shared->table.isBlocked(id);
+			}
+			if (!contains(id))
+			{
+				return false;
+			}
+			std::uint32_t position = m_entries[indexOf(id)].position;
+			const Cell &cell = (position & pendingBit) ? m_pending[position & ~pendingBit] : m_cells[position];
+			return cell.index & blockedBit;
+		}
+
+		bool contains(std::size_t id) const
+		{
+			if (m_shared)
+			{
+				return m_shared->table.contains(id);
+			}
+			std::uint32_t index = indexOf(id);
+			if (index >= m_entries.size() || m_entries[index].generation != generationOf(id))
+			{
+				return false;
+			}
+			std::uint32_t position = m_entries[index].position;
+			if (position & pendingBit)
+			{
+				position &= ~pendingBit;
+				return position < m_pending.size() && entryOf(m_pending[position]) == index;
+			}
+			return position < m_cells.size() && entryOf(m_cells[position]) == index;
+		}
+
+		// Expired slots count until they are erased
+		std::size_t size() const
+		{
+			return view().m_live;
+		}
+
+		// Tracked objects of the slot an iterator is on
+		using KeepAlive = std::vector<std::shared_ptr<void>>;
+
+		// Forward iterator over the live slots. Given keep, it locks the
+		// tracked objects of the slot it reaches into keep, replacing those of
+		// the previous one, so they stay alive while the slot is called.
+		class iterator
+		{
+		public:
+			iterator(SlotTable *table, std::size_t position, std::size_t end, KeepAlive *keep = nullptr)
+				: m_table(table), m_position(position), m_end(end), m_keep(keep)
+			{
+				skipDead();
+			}
+
+			// positions hold if a slot gives the table cells of its own
+			Slot &operator*() const
+			{
+				return m_table->view().m_cells[m_position].slot;
+			}
+
+			iterator &operator++()
+			{
+				++m_position;
+				skipDead();
+				return *this;
+			}
+
+			bool operator==(const iterator &other) const
+			{
+				return m_position == other.m_position;
+			}
+
+			bool operator!=(const iterator &other) const
+			{
+				return m_position != other.m_position;
+			}
+
+			// the last cell of a table is live, unless erased by the emission
+			bool isLast() const
+			{
+				return m_position + 1 == m_end;
+			}
+
+		private:
+			void skipDead()
+			{
+				if (m_keep)
+				{
+					m_keep->clear();
+				}
+				while (m_position != m_end && !m_table->callable(m_position, m_keep))
+				{
+					++m_position;
+				}
+			}
+
+			SlotTable *m_table;
+			std::size_t m_position;
+			std::size_t m_end;
+			KeepAlive *m_keep;
+		};
+
+		iterator begin(KeepAlive *keep = nullptr)
+		{
+			return iterator(this, 0, view().m_cells.size(), keep);
+		}
+
+		iterator end()
+		{
+			std::size_t count = view().m_cells.size();
+			return iterator(this, count, count);
+		}
+
+		// Calls f on every enabled slot but the last one, and last on that
+		// one. Iteration stops as soon as f returns false. Slots erased or
+		// blocked by the slots already called are skipped.
+		template <typename F, typename L>
+		void forEach(F &&f, L &&last)
+		{
+			// A table reading a frozen one gets cells of its own, at the same
+			// positions, if a slot changes it; the scan then goes on there.
+			SlotTable *table = &view();
+			Cell *cells = table->m_cells.begin();
+			bool reading = table != this;
+			auto call = [&](std::size_t position, auto &g)
+			{
+				bool more = table->callEnabled(cells[position], g);
+				if (reading)
+				{
+					table = &view();
+					cells = table->m_cells.begin();
+					reading = table != this;
+				}
+				return more;
+			};
+
+			std::size_t words = table->m_enabled.size();
+			while (words != 0 && table->m_enabled[words - 1] == 0)
+			{
+				--words;
+			}
+			if (words == 0)
+			{
+				return;
+			}
+
+			// Each word is scanned as it was when reached; the cell itself
+			// tells whether a slot called before erased or blocked it.
+			std::uint64_t lastBit = std::uint64_t(1) << highestBit(table->m_enabled[words - 1]);
+			for (std::size_t word = 0; word < words; ++word)
+			{
+				std::uint64_t bits = table->m_enabled[word];
+				if (word == words - 1)
+				{
+					// slots after the last one, unblocked meanwhile, wait
+					// for the next emission
+					bits &= lastBit - 1;
+				}
+				if (bits == ~std::uint64_t(0))
+				{
+					// full word: plain walk, without extracting the bits
+					for (std::size_t position = word * wordBits, end = position + wordBits; position != end; ++position)
+					{
+						if (!call(position, f))
+						{
+							return;
+						}
+					}
+					continue;
+				}
+				for (; bits != 0; bits &= bits - 1)
+				{
+					if (!call(word * wordBits + lowestBit(bits), f))
+					{
+						return;
+					}
+				}
+			}
+			call((words - 1) * wordBits + lowestBit(lastBit), last);
+		}
+
+	private:
+		static constexpr std::uint32_t npos = UINT32_MAX;
+		static constexpr std::uint32_t pendingBit = std::uint32_t(1) << 31;
+		static constexpr std::uint32_t trackedBit = std::uint32_t(1) << 31;
+		static constexpr std::uint32_t blockedBit = std::uint32_t(1) << 30;
+		static constexpr std::uint32_t sharedBit = std::uint32_t(1) << 29;
+		static constexpr std::size_t wordBits = 64;
+		static constexpr unsigned indexBits = sizeof(std::size_t) * CHAR_BIT / 2;
+		static constexpr std::size_t indexMask = (std::size_t(1) << indexBits) - 1;
+		static constexpr std::uint32_t generationMask = static_cast<std::uint32_t>(indexMask);
+
+		// index is the entry of a live cell, tagged with trackedBit when the
+		// slot is tracked, blockedBit while blocked and sharedBit when the slot
+		// calls a shared one, or npos once erased
+		struct Cell
+		{
+			template <typename... SlotArgs>
+			Cell(std::uint32_t cellIndex, SlotArgs &&...slotArgs)
+				: slot(std::forward<SlotArgs>(slotArgs)...), index(cellIndex)
+			{
+			}
+
+			Slot slot;
+			std::uint32_t index;
+		};
+
+		// position is the cell of a live entry, its place in the pending list
+		// tagged with pendingBit, or the next free entry otherwise
+		struct Entry
+		{
+			std::uint32_t position;
+			std::uint32_t generation;
+		};
+
+		struct Tracking
+		{
+			std::vector<std::weak_ptr<void>> objects;
+			bool expired = false;
+		};
+
+		static std::size_t makeId(std::uint32_t index, std::uint32_t generation)
+		{
+			return (std::size_t(generation) << indexBits) | index;
+		}
+
+		static std::uint32_t indexOf(std::size_t id)
+		{
+			return static_cast<std::uint32_t>(id & indexMask);
+		}
+
+		static std::uint32_t generationOf(std::size_t id)
+		{
+			return static_cast<std::uint32_t>(id >> indexBits);
+		}
+
+		static std::uint32_t entryOf(const Cell &cell)
+		{
+			return cell.index & ~(trackedBit | blockedBit | sharedBit);
+		}
+
+		// Position of the lowest and the highest set bit of a non-zero word
+		static unsigned lowestBit(std::uint64_t word)
+		{
+#if defined(__GNUC__)
+			return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+			unsigned bit = 0;
+			for (; !(word & 1); word >>= 1)
+			{
+				++bit;
+			}
+			return bit;
+#endif
+		}
+
+		static unsigned highestBit(std::uint64_t word)
+		{
+#if defined(__GNUC__)
+			return static_cast<unsigned>(wordBits - 1 - __builtin_clzll(word));
+#else
+			unsigned bit = 0;
+			for (; word >>= 1;)
+			{
+				++bit;
+			}
+			return bit;
+#endif
+		}
+
+		void setEnabled(std::size_t position, bool enabled)
+		{
+			std::uint64_t bit = std::uint64_t(1) << (position % wordBits);
+			std::uint64_t &word = m_enabled[position / wordBits];
+			word = enabled ? (word | bit) : (word & ~bit);
+		}
+
+		bool isEnabled(std::size_t position) const
+		{
+			return (m_enabled[position / wordBits] >> (position % wordBits)) & 1;
+		}
+
+		// Enabled, and not tracking an expired object. With keep, the tracked
+		// objects are locked into it.
+		bool callable(std::size_t position, KeepAlive *keep)
+		{
+			SlotTable &table = view();
+			const Cell &cell = table.m_cells[position];
+			if (!table.isEnabled(position))
+			{
+				return false;
+			}
+			if (cell.index < trackedBit)
+			{
+				return true;
+			}
+			return keep ? table.lockTracked(cell, *keep) : !table.expired(cell);
+		}
+
+		template <typename... SlotArgs>
+		void appendCell(std::uint32_t index, SlotArgs &&...slotArgs)
+		{
+			std::size_t position = m_cells.size();
+			if (position / wordBits == m_enabled.size())
+			{
+				m_enabled.emplace_back(0);
+			}
+			m_cells.emplace_back(index, std::forward<SlotArgs>(slotArgs)...);
+			setEnabled(position, !(index & blockedBit));
+		}
+
+		// Calls f on the slot of cell unless it was erased or blocked,
+		// returning false when f asks to stop
+		template <typename F>
+		bool callEnabled(Cell &cell, F &f)
+		{
+			if (cell.index < blockedBit)
+			{
+				if constexpr (std::is_void_v<decltype(f(cell.slot))>)
+				{
+					f(cell.slot);
+					return true;
+				}
+				else
+				{
+					return f(cell.slot);
+				}
+			}
+			if ((cell.index & (trackedBit | blockedBit)) != trackedBit)
+			{
+				return true;
+			}
+			return callTracked(cell, f);
+		}
+
+		template <typename... SlotArgs>
+		std::size_t insert(std::uint32_t flags, SlotArgs &&...slotArgs)
+		{
+			own();
+			std::uint32_t index;
+			if (m_freeEntry != npos)
+			{
+				index = m_freeEntry;
+				m_freeEntry = m_entries[index].position;
+			}
+			else
+			{
+				index = static_cast<std::uint32_t>(m_entries.size());
+				m_entries.emplace_back(Entry{npos, 0});
+			}
+
+			if (m_emitting == 0)
+			{
+				m_entries[index].position = static_cast<std::uint32_t>(m_cells.size());
+				appendCell(index | flags, std::forward<SlotArgs>(slotArgs)...);
+			}
+			else
+			{
+				m_entries[index].position = static_cast<std::uint32_t>(m_pending.size()) | pendingBit;
+				m_pending.emplace_back(index | flags, std::forward<SlotArgs>(slotArgs)...);
+			}
+			++m_live;
+			return makeId(index, m_entries[index].generation);
+		}
+
+		void eraseEntry(std::uint32_t index)
+		{
+			Entry &entry = m_entries[index];
+			Cell &cell = (entry.position & pendingBit) ? m_pending[entry.position & ~pendingBit] : m_cells[entry.position];
+			if (!(entry.position & pendingBit))
+			{
+				setEnabled(entry.position, false);
+			}
+			if (cell.index & trackedBit)
+			{
+				Tracking &tracking = m_tracking[index];
+				m_expired -= tracking.expired;
+				tracking = Tracking();
+			}
+			if (cell.index & sharedBit)
+			{
+				--m_sharedCells;
+			}
+			cell.index = npos;
+			// a slot may be erasing itself during the emission
+			if (m_emitting == 0 || (entry.position & pendingBit))
+			{
+				cell.slot = Slot();
+			}
+			else
+			{
+				m_deferredErase = true;
+			}
+
+			entry.generation = (entry.generation + 1) & generationMask;
+			entry.position = m_freeEntry;
+			m_freeEntry = index;
+			--m_live;
+		}
+
+		// The table whose cells this one reads
+		SlotTable &view()
+		{
+			return m_shared ? m_shared->table : *this;
+		}
+
+		const SlotTable &view() const
+		{
+			return m_shared ? m_shared->table : *this;
+		}
+
+		// Moves the table into a frozen one, which this table then reads
+		void freeze()
+		{
+			auto shared = std::make_shared<Shared>();
+			shared->references = std::make_unique<std::atomic<std::uint32_t>[]>(m_cells.size());
+			for (std::size_t position = 0; position < m_cells.size(); ++position)
+			{
+				shared->references[position].store(1, std::memory_order_relaxed);
+			}
+			shared->table = std::move(*this);
+			shared->table.m_frozen = true;
+			m_shared = std::move(shared);
+		}
+
+		// Gives the table cells of its own before a change: the frozen table
+		// itself when no one else holds it, outside of an emission, or cells
+		// calling its slots
+		void own()
+		{
+			if (!m_shared)
+			{
+				return;
+			}
+			// the other holders may have let go on other threads
+			if (m_emitting == 0 && m_shared.use_count() == 1)
+			{
+				std::atomic_thread_fence(std::memory_order_acquire);
+				std::shared_ptr<Shared> shared = std::move(m_shared);
+				*this = std::move(shared->table);
+				return;
+			}
+			detach();
+		}
+
+		void detach()
+		{
+			std::shared_ptr<Shared> shared = std::move(m_shared);
+			SlotTable &frozen = shared->table;
+			m_cells.reserve(frozen.m_cells.size());
+			for (std::size_t position = 0; position < frozen.m_cells.size(); ++position)
+			{
+				Cell &cell = frozen.m_cells[position];
+				if (cell.index == npos)
+				{
+					m_cells.emplace_back(npos);
+				}
+				else if (cell.index & sharedBit)
+				{
+					// straight to the slot, rather than through the frozen cell
+					m_cells.emplace_back(cell.index, cell.slot.shareTarget());
+				}
+				else
+				{
+					std::atomic<std::uint32_t> &references = shared->references[position];
+					references.fetch_add(1, std::memory_order_relaxed);
+					m_cells.emplace_back(cell.index | sharedBit, Slot::share(std::shared_ptr<Slot>(shared, &cell.slot), references));
+				}
+			}
+			m_enabled.reserve(frozen.m_enabled.size());
+			for (std::uint64_t word : frozen.m_enabled)
+			{
+				m_enabled.emplace_back(word);
+			}
+			m_entries.reserve(frozen.m_entries.size());
+			for (const Entry &entry : frozen.m_entries)
+			{
+				m_entries.emplace_back(entry);
+			}
+			m_tracking = frozen.m_tracking;
+			m_freeEntry = frozen.m_freeEntry;
+			m_live = frozen.m_live;
+			m_expired = frozen.m_expired;
+			m_sharedCells = frozen.m_live;
+			// an emission may still be calling a frozen cell
+			if (m_emitting != 0)
+			{
+				m_retired = std::move(shared);
+			}
+			else
+			{
+				leave(*shared);
+			}
+		}
+
+		void leaveShared()
+		{
+			if (m_shared)
+			{
+				leave(*m_shared);
+				m_shared.reset();
+			}
+		}
+
+		// A table stops reading shared. The last reader gives up the readers'
+		// hold on every slot, destroying those no other cell calls.
+		static void leave(Shared &shared)
+		{
+			if (shared.readers.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			{
+				return;
+			}
+			SlotTable &frozen = shared.table;
+			for (std::size_t position = 0; position < frozen.m_cells.size(); ++position)
+			{
+				Cell &cell = frozen.m_cells[position];
+				if (cell.index != npos && ((cell.index & sharedBit) || shared.references[position].fetch_sub(1, std::memory_order_acq_rel) == 1))
+				{
+					cell.slot = Slot();
+				}
+			}
+		}
+
+		// Emissions take back what the other tables let go, as changes do: the
+		// frozen table once no other one holds it, the shared slots over one
+		// pass per as many emissions as there are cells
+		void reclaimIdle()
+		{
+			if (m_shared)
+			{
+				if (m_shared.use_count() == 1)
+				{
+					own();
+				}
+			}
+			else if (m_sharedCells != 0 && ++m_changes >= m_cells.size())
+			{
+				reclaimShared();
+			}
+		}
+
+		// Takes back the shared slots no other table calls anymore
+		void reclaimShared()
+		{
+			m_changes = 0;
+			for (Cell &cell : m_cells)
+			{
+				if (cell.index != npos && (cell.index & sharedBit) && cell.slot.unshare())
+				{
+					cell.index &= ~sharedBit;
+					--m_sharedCells;
+				}
+			}
+		}
+
+		// cell is not used once pred has run: a pending cell moves if pred
+		// connects slots
+		template <typename Predicate>
+		bool eraseCellIf(const Cell &cell, Predicate &pred)
+		{
+			if (cell.index == npos)
+			{
+				return false;
+			}
+			std::uint32_t index = entryOf(cell);
+			if (!pred(makeId(index, m_entries[index].generation)))
+			{
+				return false;
+			}
+			eraseEntry(index);
+			return true;
+		}
+
+		// Calls f with the objects tracked by cell kept alive, unless one has
+		// expired. Returns false when f asks to stop.
+		template <typename F>
+		bool callTracked(Cell &cell, F &f)
+		{
+			SmallVector<std::shared_ptr<void>, 4> locks;
+			if (!lockTracked(cell, locks))
+			{
+				return true;
+			}
+			// tracking may move if the slot connects tracked slots
+			if constexpr (std::is_void_v<decltype(f(cell.slot))>)
+			{
+				f(cell.slot);
+				return true;
+			}
+			else
+			{
+				return f(cell.slot);
+			}
+		}
+
+		// Appends the objects tracked by cell to locks, unless one has expired
+		template <typename Locks>
+		bool lockTracked(const Cell &cell, Locks &locks)
+		{
+			const Tracking &tracking = m_tracking[entryOf(cell)];
+			if (tracking.expired)
+			{
+				return false;
+			}
+			for (const std::weak_ptr<void> &object : tracking.objects)
+			{
+				std::shared_ptr<void> locked = object.lock();
+				if (!locked)
+				{
+					markExpired(cell);
+					return false;
+				}
+				locks.emplace_back(std::move(locked));
+			}
+			return true;
+		}
+
+		bool expired(const Cell &cell)
+		{
+			const Tracking &tracking = m_tracking[entryOf(cell)];
+			if (tracking.expired)
+			{
+				return true;
+			}
+			for (const std::weak_ptr<void> &object : tracking.objects)
+			{
+				if (object.expired())
+				{
+					markExpired(cell);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// A frozen table, read by other tables, is left as it is: its expired
+		// slots are found again on each emission
+		void markExpired(const Cell &cell)
+		{
+			if (m_frozen)
+			{
+				return;
+			}
+			m_tracking[entryOf(cell)].expired = true;
+			++m_expired;
+		}
+
+		bool sweepDue() const
+		{
+			return m_expired != 0 && m_expired * 4 >= m_live;
+		}
+
+		void trim()
+		{
+			while (!m_cells.empty() && m_cells.back().index == npos)
+			{
+				m_cells.pop_back();
+			}
+			if (m_cells.size() - m_live > m_live)
+			{
+				compact();
+			}
+			m_enabled.truncate((m_cells.size() + wordBits - 1) / wordBits);
+			// one pass per as many changes as there are cells
+			if (m_sharedCells != 0 && ++m_changes >= m_cells.size())
+			{
+				reclaimShared();
+			}
+		}
+
+		// Erases the expired slots, destroys the slots erased and appends the
+		// slots connected during the emission that just ended
+		void applyDeferred()
+		{
+			if (sweepDue())
+			{
+				for (Cell &cell : m_cells)
+				{
+					if (cell.index != npos && (cell.index & trackedBit) && m_tracking[entryOf(cell)].expired)
+					{
+						eraseEntry(entryOf(cell));
+					}
+				}
+			}
+			if (m_deferredErase)
+			{
+				m_deferredErase = false;
+				for (Cell &cell : m_cells)
+				{
+					if (cell.index == npos)
+					{
+						cell.slot = Slot();
+					}
+				}
+			}
+			for (Cell &cell : m_pending)
+			{
+				if (cell.index != npos)
+				{
+					m_entries[entryOf(cell)].position = static_cast<std::uint32_t>(m_cells.size());
+					appendCell(cell.index, std::move(cell.slot));
+				}
+			}
+			m_pending.clear();
+			trim();
+		}
+
+		void compact()
+		{
+			std::size_t out = 0;
+			for (std::size_t in = 0; in < m_cells.size(); ++in)
+			{
+				if (m_cells[in].index == npos)
+				{
+					continue;
+				}
+				if (in != out)
+				{
+					m_cells[out] = std::move(m_cells[in]);
+				}
+				m_entries[entryOf(m_cells[out])].position = static_cast<std::uint32_t>(out);
+				++out;
+			}
+			m_cells.truncate(out);
+
+			for (std::uint64_t &word : m_enabled)
+			{
+				word = 0;
+			}
+			for (std::size_t position = 0; position < out; ++position)
+			{
+				setEnabled(position, !(m_cells[position].index & blockedBit));
+			}
+		}
+
+		SmallVector<Cell, 1> m_cells;
+		SmallVector<std::uint64_t, 1> m_enabled;
+		SmallVector<Entry, 1> m_entries;
+		std::vector<Cell> m_pending;
+		std::vector<Tracking> m_tracking;
+		// frozen table read in place of the cells, and one an emission left
+		std::shared_ptr<Shared> m_shared;
+		std::shared_ptr<Shared> m_retired;
+		std::uint32_t m_freeEntry = npos;
+		std::size_t m_live = 0;
+		std::size_t m_expired = 0;
+		std::size_t m_sharedCells = 0;
+		std::size_t m_changes = 0;
+		unsigned m_emitting = 0;
+		bool m_deferredErase = false;
+		bool m_frozen = false;
+	};
+
+	// A frozen table and the holders of each of its slots: one for all the
+	// tables reading it, plus one per cell of a table calling the slot from
+	// cells of its own
+	template <typename Slot>
+	struct SlotTable<Slot>::Shared
+	{
+		SlotTable table;
+		std::unique_ptr<std::atomic<std::uint32_t>[]> references;
+		std::atomic<std::size_t> readers{2};
+	};
+
+	/*******************************************************************************
+	 *                               SlotCallIterator
+	 *******************************************************************************/
+
+	// Input iterator over the results of one emission. A slot is invoked when
+	// its position is first dereferenced, so a range combiner, called as
+	// combiner(first, last), only pays for the results it pulls.
+	template <typename SlotIterator, typename Caller>
+	class SlotCallIterator
+	{
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = std::remove_cv_t<std::remove_reference_t<typename Caller::result_type>>;
+		using difference_type = std::ptrdiff_t;
+		using reference = typename Caller::reference;
+		using pointer = std::add_pointer_t<reference>;
+
+	private:
+		static constexpr bool returnsReference = std::is_reference_v<typename Caller::result_type>;
+
+	public:
+
+		SlotCallIterator(SlotIterator position, Caller *caller)
+			: m_position(position), m_caller(caller)
+		{
+		}
+
+		reference operator*() const
+		{
+			return m_caller->call(m_position);
+		}
+
+		pointer operator->() const
+		{
+			return std::addressof(m_caller->call(m_position));
+		}
+
+		SlotCallIterator &operator++()
+		{
+			++m_position;
+			return *this;
+		}
+
+		// The result is taken before moving on, so *it++ does not call twice.
+		// Slots returning references have the reference kept instead.
+		class PostIncrement
+		{
+		public:
+			explicit PostIncrement(reference value)
+			{
+				if constexpr (returnsReference)
+				{
+					m_value = std::addressof(value);
+				}
+				else
+				{
+					m_value.emplace(std::move(value));
+				}
+			}
+
+			reference operator*()
+			{
+				return *m_value;
+			}
+
+		private:
+			std::conditional_t<returnsReference, pointer, std::optional<value_type>> m_value;
+		};
+
+		PostIncrement operator++(int)
+		{
+			PostIncrement previous(**this);
+			++*this;
+			return previous;
+		}
+
+		bool operator==(const SlotCallIterator &other) const
+		{
+			return m_position == other.m_position;
+		}
+
+		bool operator!=(const SlotCallIterator &other) const
+		{
+			return m_position != other.m_position;
+		}
+
+	private:
+		SlotIterator m_position;
+		Caller *m_caller;
+	};
+
+	template <typename Combiner, typename Iterator>
+	constexpr bool isRangeCombiner = std::is_invocable_v<Combiner &, Iterator, Iterator>;
+
+	/*******************************************************************************
+	 *                               Connection
+	 *******************************************************************************/
+
+	// Shared by a signal and the handles to its connections, so a handle can
+	// tell when the signal is gone. Signals create it on the first connect()
+	// and detach from it when destroyed; the last owner frees it. Like the
+	// signal itself, it is not thread-safe.
+	class ConnectionAnchor
+	{
+	public:
+		using Contains = bool (*)(const void *, std::size_t);
+		using Erase = bool (*)(void *, std::size_t);
+
+		ConnectionAnchor(void *owner, Contains contains, Erase erase) noexcept
+			: m_owner(owner), m_contains(contains), m_erase(erase)
+		{
+		}
+
+		ConnectionAnchor(const ConnectionAnchor &) = delete;
+		ConnectionAnchor &operator=(const ConnectionAnchor &) = delete;
+
+		void retain() noexcept
+		{
+			++m_references;
+		}
+
+		void release() noexcept
+		{
+			if (--m_references == 0)
+			{
+				delete this;
+			}
+		}
+
+		// The owner moved to another address
+		void rebind(void *owner) noexcept
+		{
+			m_owner = owner;
+		}
+
+		// The owner is going away
+		void detach() noexcept
+		{
+			m_owner = nullptr;
+			release();
+		}
+
+		bool contains(std::size_t id) const
+		{
+			return m_owner && m_contains(m_owner, id);
+		}
+
+		bool erase(std::size_t id)
+		{
+			return m_owner && m_erase(m_owner, id);
+		}
+
+	private:
+		void *m_owner;
+		Contains m_contains;
+		Erase m_erase;
+		std::size_t m_references = 1;
+	};
+
+	// Handle to a connection. Disconnecting goes straight to the slot entry
+	// the id designates and checks its generation, without any search, and
+	// is harmless once the slot or the signal is gone.
+	class Connection
+	{
+	public:
+		Connection() noexcept = default;
+
+		Connection(ConnectionAnchor *anchor, std::size_t id) noexcept
+			: m_anchor(anchor), m_id(id)
+		{
+			m_anchor->retain();
+		}
+
+		Connection(const Connection &other) noexcept
+			: m_anchor(other.m_anchor), m_id(other.m_id)
+		{
+			if (m_anchor)
+			{
+				m_anchor->retain();
+			}
+		}
+
+		Connection(Connection &&other) noexcept
+			: m_anchor(std::exchange(other.m_anchor, nullptr)), m_id(other.m_id)
+		{
+		}
+
+		Connection &operator=(Connection other) noexcept
+		{
+			std::swap(m_anchor, other.m_anchor);
+			std::swap(m_id, other.m_id);
+			return *this;
+		}
+
+		~Connection()
+		{
+			if (m_anchor)
+			{
+				m_anchor->release();
+			}
+		}
+
+		bool connected() const
+		{
+			return m_anchor && m_anchor->contains(m_id);
+		}
+
+		void disconnect()
+		{
+			if (m_anchor)
+			{
+				m_anchor->erase(m_id);
+				std::exchange(m_anchor, nullptr)->release();
+			}
+		}
+
+		std::size_t id() const noexcept
+		{
+			return m_id;
+		}
+
+	private:
+		ConnectionAnchor *m_anchor = nullptr;
+		std::size_t m_id = 0;
+	};
+
+	// Connection disconnected when the handle is destroyed or reassigned
+	class ScopedConnection
+	{
+	public:
+		ScopedConnection() noexcept = default;
+
+		ScopedConnection(Connection connection) noexcept
+			: m_connection(std::move(connection))
+		{
+		}
+
+		ScopedConnection(ScopedConnection &&other) noexcept = default;
+
+		ScopedConnection &operator=(ScopedConnection &&other)
+		{
+			if (this != &other)
+			{
+				m_connection.disconnect();
+				m_connection = std::move(other.m_connection);
+			}
+			return *this;
+		}
+
+		ScopedConnection(const ScopedConnection &) = delete;
+		ScopedConnection &operator=(const ScopedConnection &) = delete;
+
+		~ScopedConnection()
+		{
+			m_connection.disconnect();
+		}
+
+		bool connected() const
+		{
+			return m_connection.connected();
+		}
+
+		void disconnect()
+		{
+			m_connection.disconnect();
+		}
+
+		// Gives up the ownership without disconnecting
+		Connection release() noexcept
+		{
+			return std::move(m_connection);
+		}
+
+	private:
+		Connection m_connection;
+	};
+
+	/*******************************************************************************
+	 *                               Signal
+	 *******************************************************************************/
+
+	template <typename Signature, typename Combiner = DiscardCombiner, std::size_t SlotBufferSize = defaultSlotBufferSize>
+	class Signal;
+
+	template <typename R, typename... Args, typename Combiner, std::size_t SlotBufferSize>
+	class Signal<R(Args...), Combiner, SlotBufferSize>
+	{
+
+	public:
+		using combiner_type = Combiner;
+		using result_type = typename Combiner::result_type;
+		using signature_type = R(Args...);
+		using slot_type = SlotFunction<signature_type, SlotBufferSize>;
+
+		Signal(Combiner combiner = Combiner())
+			: m_combiner(std::move(combiner))
+		{
+		}
+
+		// Connection handles and coroutines waiting on next() follow the
+		// slots to the new signal
+		Signal(Signal &&other) noexcept(std::is_nothrow_move_constructible_v<Combiner>)
+			: m_combiner(std::move(other.m_combiner)),
+			  m_slots(std::move(other.m_slots)),
+			  m_waiters(std::exchange(other.m_waiters, nullptr)),
+			  m_anchor(std::exchange(other.m_anchor, nullptr))
+		{
+			rebind();
+		}
+
+		// Coroutines already waiting on next() keep waiting on this signal,
+		// resumed before those coming with other
+		Signal &operator=(Signal &&other) noexcept(std::is_nothrow_move_assignable_v<Combiner>)
+		{
+			if (this != &other)
+			{
+				m_combiner = std::move(other.m_combiner);
+				m_slots = std::move(other.m_slots);
+				waiter_type **tail = &other.m_waiters;
+				while (*tail)
+				{
+					tail = &(*tail)->next;
+				}
+				*tail = m_waiters;
+				m_waiters = std::exchange(other.m_waiters, nullptr);
+				if (m_anchor)
+				{
+					m_anchor->detach();
+				}
+				m_anchor = std::exchange(other.m_anchor, nullptr);
+				rebind();
+			}
+			return *this;
+		}
+
+		~Signal()
+		{
+			if (m_anchor)
+			{
+				m_anchor->detach();
+			}
+		}
+
+		// Slots are move-only: copies go through clone()
+		Signal(const Signal &) = delete;
+		Signal &operator=(const Signal &) = delete;
+
+		// Signal with the same slots, ids and blocked slots, and a fresh copy of
+		// the combiner. The slots are not copied but shared by the two signals,
+		// which then connect and disconnect independently; a stateful slot
+		// sees the calls of both. The slot table itself is shared until one of
+		// them changes, so cloning costs the same for any number of slots.
+		// Connection handles and coroutines waiting on next() stay with this
+		// signal. Not to be called during an emission.
+		Signal clone() const
+		{
+			return Signal(freshCombiner(m_combiner), m_slots.share());
+		}
+
+		void swap(Signal &other) noexcept(std::is_nothrow_swappable_v<Combiner>)
+		{
+			using std::swap;
+			swap(m_combiner, other.m_combiner);
+			swap(m_slots, other.m_slots);
+			swap(m_waiters, other.m_waiters);
+			swap(m_anchor, other.m_anchor);
+			rebind();
+			other.rebind();
+		}
+
+		friend void swap(Signal &a, Signal &b) noexcept(std::is_nothrow_swappable_v<Combiner>)
+		{
+			a.swap(b);
+		}
+
+		template <typename F>
+		std::size_t connectSlot(F &&callback)
+		{
+			return m_slots.emplace(std::forward<F>(callback));
+		}
+
+		template <auto Function>
+		std::size_t connectSlot()
+		{
+			return m_slots.emplace(slot_type::template bind<Function>());
+		}
+
+		template <auto Method, typename T>
+		std::size_t connectSlot(T *object)
+		{
+			return m_slots.emplace(slot_type::template bind<Method>(object));
+		}
+
+		// Queued connection: callback runs on the thread draining executor
+		template <typename Executor, typename F>
+		std::size_t connectSlot(Executor &executor, F &&callback)
+		{
+			return m_slots.emplace(queuedSlot<signature_type>(executor, std::forward<F>(callback)));
+		}
+
+		// Connects callback for as long as every one of objects, given as
+		// std::shared_ptr or std::weak_ptr, is alive. Each call keeps them
+		// alive until it returns; once one has expired the slot is skipped and
+		// later disconnected, in a batch with the other expired slots.
+		template <typename F, typename... Objects>
+		std::size_t connectTracked(F &&callback, const Objects &...objects)
+		{
+			static_assert(sizeof...(Objects) > 0, "connectTracked needs objects to track");
+			return m_slots.emplaceTracked(trackedObjects(objects...), std::forward<F>(callback));
+		}
+
+		// Delegate to a method of object, tracking object
+		template <auto Method, typename T>
+		std::size_t connectTracked(const std::shared_ptr<T> &object)
+		{
+			return m_slots.emplaceTracked(trackedObjects(object), slot_type::template bind<Method>(object.get()));
+		}
+
+		// Connects every callable of slots in order, reserving room for all
+		// of them at once when the range can be measured. Callables are moved
+		// out of an rvalue range. The ids are written to ids.
+		template <typename Range, typename OutputIt>
+		OutputIt connectSlots(Range &&slots, OutputIt ids)
+		{
+			using std::begin;
+			using std::end;
+			auto first = begin(slots);
+			auto last = end(slots);
+			using category = typename std::iterator_traits<decltype(first)>::iterator_category;
+			if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>)
+			{
+				m_slots.reserve(static_cast<std::size_t>(std::distance(first, last)));
+			}
+			for (; first != last; ++first)
+			{
+				if constexpr (std::is_rvalue_reference_v<Range &&>)
+				{
+					*ids = connectSlot(std::move(*first));
+				}
+				else
+				{
+					*ids = connectSlot(*first);
+				}
+				++ids;
+			}
+			return ids;
+		}
+
+		template <typename Range>
+		void connectSlots(Range &&slots)
+		{
+			connectSlots(std::forward<Range>(slots), DiscardIds());
+		}
+
+		void disconnectSlot(std::size_t id)
+		{
+			m_slots.erase(id);
+		}
+
+		void disconnectAll()
+		{
+			auto all = [](std::size_t) { return true; };
+			m_slots.eraseIf(all);
+		}
+
+		// Disconnects, in one pass, the slots whose id satisfies predicate,
+		// and returns how many there were
+		template <typename Predicate>
+		std::size_t disconnectIf(Predicate predicate)
+		{
+			return m_slots.eraseIf(predicate);
+		}
+
+		// Mutes a slot: it keeps its place and id, but emissions skip it until
+		// unblocked. Blocking is not counted: one unblock undoes any blocks.
+		void block(std::size_t id)
+		{
+			m_slots.setBlocked(id, true);
+		}
+
+		void unblock(std::size_t id)
+		{
+			m_slots.setBlocked(id, false);
+		}
+
+		bool isBlocked(std::size_t id) const
+		{
+			return m_slots.isBlocked(id);
+		}
+
+		void block(const Connection &connection)
+		{
+			block(connection.id());
+		}
+
+		void unblock(const Connection &connection)
+		{
+			unblock(connection.id());
+		}
+
+		bool isBlocked(const Connection &connection) const
+		{
+			return isBlocked(connection.id());
+		}
+
+		// Same as connectSlot, returning a handle to the connection
+		template <typename F>
+		Connection connect(F &&callback)
+		{
+			return makeConnection(connectSlot(std::forward<F>(callback)));
+		}
+
+		template <auto Function>
+		Connection connect()
+		{
+			return makeConnection(connectSlot<Function>());
+		}
+
+		template <auto Method, typename T>
+		Connection connect(T *object)
+		{
+			return makeConnection(connectSlot<Method>(object));
+		}
+
+		template <typename Executor, typename F>
+		Connection connect(Executor &executor, F &&callback)
+		{
+			return makeConnection(connectSlot(executor, std::forward<F>(callback)));
+		}
+
+		std::size_t slotCount() const
+		{
+			return m_slots.size();
+		}
+
+		// Arguments are converted to the signature types once, shared by const
+		// reference with every slot, and moved into the last slot when possible.
+		template <typename... EmitArgs, typename = std::enable_if_t<sizeof...(EmitArgs) == sizeof...(Args)>>
+		result_type emitSignal(EmitArgs &&...args)
+		{
+			if (m_waiters)
+			{
+				return emitNotifying(adaptArgument<Args>(std::forward<EmitArgs>(args))...);
+			}
+			return emitArguments(adaptArgument<Args>(std::forward<EmitArgs>(args))...);
+		}
+
+		// Awaitable resuming the awaiting coroutine after the next emitSignal,
+		// with copies of its arguments. Requires SignalCoro.h.
+		NextEmission<Signal> next()
+		{
+			return NextEmission<Signal>(*this);
+		}
+
+		// Writes the slot results to out, bypassing the combiner
+		template <typename OutputIt, typename... EmitArgs, typename = std::enable_if_t<sizeof...(EmitArgs) == sizeof...(Args)>>
+		OutputIt emitInto(OutputIt out, EmitArgs &&...args)
+		{
+			static_assert(!std::is_void_v<R>, "slots of this signal return no result");
+			invokeSlots([&](auto &&result)
+						{ *out = std::forward<decltype(result)>(result); ++out; return true; },
+						adaptArgument<Args>(std::forward<EmitArgs>(args))...);
+			return out;
+		}
+
+		// Replaces the content of results, reusing its capacity across emissions
+		template <typename T, typename Allocator, typename... EmitArgs, typename = std::enable_if_t<sizeof...(EmitArgs) == sizeof...(Args)>>
+		void emitInto(std::vector<T, Allocator> &results, EmitArgs &&...args)
+		{
+			static_assert(!std::is_void_v<R>, "slots of this signal return no result");
+			results.clear();
+			results.reserve(m_slots.size());
+			invokeSlots([&](auto &&result)
+						{ results.emplace_back(std::forward<decltype(result)>(result)); return true; },
+						adaptArgument<Args>(std::forward<EmitArgs>(args))...);
+		}
+
+		// Runs the slots concurrently on pool, anything with parallelFor(count,
+		// f) and threadCount() like ThreadPool, the calling thread taking part.
+		// Every slot gets the arguments by const reference and must be safe to
+		// run alongside the others. Results still reach the combiner in
+		// connection order. A mergeable combiner is copied per chunk of slots
+		// and the partials merged; otherwise results are buffered and combined
+		// at the end, where stopping early only skips results.
+		template <typename Pool, typename... EmitArgs, typename = std::enable_if_t<sizeof...(EmitArgs) == sizeof...(Args)>>
+		result_type emitParallel(Pool &pool, EmitArgs &&...args)
+		{
+			return emitParallelArguments(pool, adaptArgument<Args>(std::forward<EmitArgs>(args))...);
+		}
+
+		// Emits on the calling thread and returns a future of the result,
+		// completed once the slots this emission queued to executors have run
+		// too. Requires Future.h.
+		template <typename... EmitArgs, typename = std::enable_if_t<sizeof...(EmitArgs) == sizeof...(Args)>>
+		Future<result_type> emitAsync(EmitArgs &&...args)
+		{
+			Promise<result_type> promise;
+			Future<result_type> future = promise.getFuture();
+			promise.track([&]() -> result_type
+						  { return emitSignal(std::forward<EmitArgs>(args)...); });
+			return future;
+		}
+
+		// Same, with the emission itself posted to executor. The arguments are
+		// copied into the task; the signal must outlive the emission.
+		template <typename Executor, typename... EmitArgs, typename = std::enable_if_t<sizeof...(EmitArgs) == sizeof...(Args)>>
+		Future<result_type> emitAsync(Executor &executor, EmitArgs &&...args)
+		{
+			static_assert(!(... || (std::is_lvalue_reference_v<Args> && !std::is_const_v<std::remove_reference_t<Args>>)),
+						  "Posted emissions cannot take non-const references");
+			Promise<result_type> promise;
+			Future<result_type> future = promise.getFuture();
+			executor.post([this, promise = std::move(promise),
+						   arguments = std::tuple<std::decay_t<Args>...>(std::forward<EmitArgs>(args)...)]() mutable
+						  { promise.track([&]() -> result_type
+										  { return std::apply([&](auto &...values) -> result_type
+															  { return emitSignal(std::move(values)...); },
+															  arguments); }); });
+			return future;
+		}
+
+#if defined(__cpp_lib_span)
+		// Fills results in connection order and returns how many were written.
+		// Results of slots past the end of the span are discarded.
+		template <typename T, std::size_t Extent, typename... EmitArgs, typename = std::enable_if_t<sizeof...(EmitArgs) == sizeof...(Args)>>
+		std::size_t emitInto(std::span<T, Extent> results, EmitArgs &&...args)
+		{
+			static_assert(!std::is_void_v<R>, "slots of this signal return no result");
+			std::size_t count = 0;
+			invokeSlots([&](auto &&result)
+						{
+							if (count < results.size())
+							{
+								results[count++] = std::forward<decltype(result)>(result);
+							}
+							return true; },
+						adaptArgument<Args>(std::forward<EmitArgs>(args))...);
+			return count;
+		}
+#endif
+
+	private:
+		friend class NextEmission<Signal>;
+
+		using slot_iterator = typename SlotTable<slot_type>::iterator;
+		using waiter_type = NextWaiter<Args...>;
+
+		Signal(Combiner &&combiner, SlotTable<slot_type> &&slots)
+			: m_combiner(std::move(combiner)), m_slots(std::move(slots))
+		{
+		}
+
+		// Output iterator dropping the ids of connectSlots(slots)
+		struct DiscardIds
+		{
+			DiscardIds &operator*()
+			{
+				return *this;
+			}
+
+			DiscardIds &operator++()
+			{
+				return *this;
+			}
+
+			DiscardIds &operator=(std::size_t)
+			{
+				return *this;
+			}
+		};
+
+		// Waiters are resumed in the order they started waiting, even when the
+		// slots throw. Waiting again during the resumption waits for the
+		// following emission.
+		template <typename... EmitArgs>
+		result_type emitNotifying(EmitArgs &&...args)
+		{
+			struct Resume
+			{
+				~Resume()
+				{
+					while (waiters)
+					{
+						waiter_type *waiter = waiters;
+						waiters = waiter->next;
+						waiter->resume(waiter);
+					}
+				}
+
+				waiter_type *waiters;
+			} resume{nullptr};
+
+			for (waiter_type *waiter = std::exchange(m_waiters, nullptr); waiter;)
+			{
+				waiter_type *next = std::exchange(waiter->next, resume.waiters);
+				resume.waiters = waiter;
+				waiter = next;
+			}
+			for (waiter_type *waiter = resume.waiters; waiter; waiter = waiter->next)
+			{
+				waiter->receive(waiter, sharedArgument<Args, EmitArgs>(args)...);
+			}
+			return emitArguments(std::forward<EmitArgs>(args)...);
+		}
+
+		template <typename... Objects>
+		static std::vector<std::weak_ptr<void>> trackedObjects(const Objects &...objects)
+		{
+			std::vector<std::weak_ptr<void>> tracked;
+			tracked.reserve(sizeof...(Objects));
+			(tracked.emplace_back(objects), ...);
+			return tracked;
+		}
+
+		Connection makeConnection(std::size_t id)
+		{
+			if (!m_anchor)
+			{
+				m_anchor = new ConnectionAnchor(this, &containsSlot, &eraseSlot);
+			}
+			return Connection(m_anchor, id);
+		}
+
+		static bool containsSlot(const void *signal, std::size_t id)
+		{
+			return static_cast<const Signal *>(signal)->m_slots.contains(id);
+		}
+
+		static bool eraseSlot(void *signal, std::size_t id)
+		{
+			return static_cast<Signal *>(signal)->m_slots.erase(id);
+		}
+
+		void addWaiter(waiter_type *waiter)
+		{
+			waiter->signal = this;
+			waiter->next = std::exchange(m_waiters, waiter);
+		}
+
+		// Points the connection anchor and the waiters at this signal
+		void rebind() noexcept
+		{
+			if (m_anchor)
+			{
+				m_anchor->rebind(this);
+			}
+			for (waiter_type *waiter = m_waiters; waiter; waiter = waiter->next)
+			{
+				waiter->signal = this;
+			}
+		}
+
+		// Unregisters a waiter dropped before the emission it awaited
+		void removeWaiter(waiter_type *waiter)
+		{
+			for (waiter_type **link = &m_waiters; *link; link = &(*link)->next)
+			{
+				if (*link == waiter)
+				{
+					*link = waiter->next;
+					return;
+				}
+			}
+		}
+
+		// Invokes slots for a SlotCallIterator and keeps the result of the
+		// position last dereferenced
+		template <typename... EmitArgs>
+		class SlotCaller
+		{
+		public:
+			using result_type = R;
+			using reference = std::remove_reference_t<R> &;
+
+			explicit SlotCaller(std::remove_reference_t<EmitArgs> &...args)
+				: m_args(args...)
+			{
+			}
+
+			reference call(slot_iterator position)
+			{
+				if (!m_result || m_position != position)
+				{
+					m_result.reset();
+					m_position = position;
+					std::apply([&](auto &...args)
+							   {
+								   if constexpr (movesToLastSlot<signature_type, EmitArgs...>)
+								   {
+									   if (position.isLast())
+									   {
+										   keep((*position).invokeLast(lastArgument<Args, EmitArgs>(args)...));
+										   return;
+									   }
+								   }
+								   keep((*position).invoke(sharedArgument<Args, EmitArgs>(args)...)); },
+							   m_args);
+				}
+				if constexpr (std::is_reference_v<R>)
+				{
+					return **m_result;
+				}
+				else
+				{
+					return *m_result;
+				}
+			}
+
+		private:
+			// results returned by reference are kept as pointers
+			using stored_type = std::conditional_t<std::is_reference_v<R>, std::remove_reference_t<R> *, R>;
+
+			void keep(R &&result)
+			{
+				if constexpr (std::is_reference_v<R>)
+				{
+					m_result.emplace(std::addressof(result));
+				}
+				else
+				{
+					m_result.emplace(std::move(result));
+				}
+			}
+
+			std::tuple<std::remove_reference_t<EmitArgs> &...> m_args;
+			std::optional<stored_type> m_result;
+			std::optional<slot_iterator> m_position;
+		};
+
+		template <typename... EmitArgs>
+		using call_iterator = SlotCallIterator<slot_iterator, SlotCaller<EmitArgs...>>;
+
+		template <typename... EmitArgs>
+		static constexpr bool usesRangeCombiner()
+		{
+			if constexpr (std::is_void_v<R>)
+			{
+				return false;
+			}
+			else
+			{
+				return isRangeCombiner<combiner_type, call_iterator<EmitArgs...>>;
+			}
+		}
+
+		template <typename... EmitArgs>
+		result_type emitArguments(EmitArgs &&...args)
+		{
+			if constexpr (usesRangeCombiner<EmitArgs...>())
+			{
+				combiner_type combiner = makeCombiner(m_combiner, m_slots.size());
+				SlotCaller<EmitArgs...> caller(args...);
+				typename SlotTable<slot_type>::EmissionScope scope(m_slots);
+				// the tracked objects of the slot being called stay alive
+				typename SlotTable<slot_type>::KeepAlive keep;
+				return combiner(call_iterator<EmitArgs...>(m_slots.begin(&keep), &caller),
+								call_iterator<EmitArgs...>(m_slots.end(), &caller));
+			}
+			else if constexpr (std::is_void_v<result_type>)
+			{
+				invokeSlots([](auto &&)
+							{ return true; },
+							std::forward<EmitArgs>(args)...);
+			}
+			else
+			{
+				combiner_type combiner = makeCombiner(m_combiner, m_slots.size());
+				invokeSlots([&](auto &&result)
+							{ return combineItem(combiner, std::forward<decltype(result)>(result)); },
+							std::forward<EmitArgs>(args)...);
+				return combiner.result();
+			}
+		}
+
+		template <typename Pool, typename... EmitArgs>
+		result_type emitParallelArguments(Pool &pool, EmitArgs &&...args)
+		{
+			static_assert(!usesRangeCombiner<EmitArgs...>(), "emitParallel needs a combiner taking results one by one");
+			static_assert(!std::is_reference_v<R>, "emitParallel needs slots returning by value");
+
+			typename SlotTable<slot_type>::EmissionScope scope(m_slots);
+			SmallVector<slot_type *, 16> slots;
+			// tracked objects stay alive until every slot has returned
+			typename SlotTable<slot_type>::KeepAlive keep;
+			typename SlotTable<slot_type>::KeepAlive kept;
+			for (auto slot = m_slots.begin(&keep), end = m_slots.end(); slot != end; ++slot)
+			{
+				slots.emplace_back(&*slot);
+				kept.insert(kept.end(), std::make_move_iterator(keep.begin()), std::make_move_iterator(keep.end()));
+			}
+
+			if constexpr (std::is_void_v<R> || std::is_void_v<result_type>)
+			{
+				pool.parallelFor(slots.size(), [&](std::size_t index)
+								 { static_cast<void>(slots[index]->invoke(sharedArgument<Args, EmitArgs>(args)...)); });
+				if constexpr (!std::is_void_v<result_type>)
+				{
+					return makeCombiner(m_combiner, slots.size()).result();
+				}
+			}
+			else if constexpr (hasMerge<combiner_type>::value)
+			{
+				// Contiguous chunks of slots combine into their own combiner,
+				// merged in connection order once every chunk is done
+				std::size_t chunkCount = std::min<std::size_t>(slots.size(), 4 * (pool.threadCount() + 1));
+				auto chunkBegin = [&](std::size_t chunk)
+				{ return chunk * slots.size() / chunkCount; };
+				std::vector<combiner_type> partials;
+				partials.reserve(chunkCount);
+				for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+				{
+					partials.push_back(makeCombiner(m_combiner, chunkBegin(chunk + 1) - chunkBegin(chunk)));
+				}
+
+				using Invocation = SlotInvocation<signature_type, EmitArgs...>;
+				pool.parallelFor(chunkCount, [&](std::size_t chunk)
+								 {
+									 auto sink = [&](auto &&result)
+									 { return combineItem(partials[chunk], std::forward<decltype(result)>(result)); };
+									 for (std::size_t index = chunkBegin(chunk); index < chunkBegin(chunk + 1); ++index)
+									 {
+										 if (!Invocation::invoke(*slots[index], sink, args...))
+										 {
+											 break;
+										 }
+									 } });
+
+				if (partials.empty())
+				{
+					return makeCombiner(m_combiner, 0).result();
+				}
+				combiner_type combiner = std::move(partials.front());
+				for (std::size_t chunk = 1; chunk < chunkCount; ++chunk)
+				{
+					combiner.merge(std::move(partials[chunk]));
+				}
+				return combiner.result();
+			}
+			else
+			{
+				std::vector<std::optional<R>> results(slots.size());
+				pool.parallelFor(slots.size(), [&](std::size_t index)
+								 { results[index].emplace(slots[index]->invoke(sharedArgument<Args, EmitArgs>(args)...)); });
+				combiner_type combiner = makeCombiner(m_combiner, slots.size());
+				for (std::optional<R> &result : results)
+				{
+					if (!combineItem(combiner, std::move(*result)))
+					{
+						break;
+					}
+				}
+				return combiner.result();
+			}
+		}
+
+		// Invokes the slots in connection order and hands non-void results to
+		// sink, until sink returns false
+		template <typename Sink, typename... EmitArgs>
+		void invokeSlots(Sink &&sink, EmitArgs &&...args)
+		{
+			using Invocation = SlotInvocation<signature_type, EmitArgs...>;
+			typename SlotTable<slot_type>::EmissionScope scope(m_slots);
+			m_slots.forEach([&](slot_type &slot)
+							{ return Invocation::invoke(slot, sink, args...); },
+							[&](slot_type &slot)
+							{ Invocation::invokeLast(slot, sink, args...); });
+		}
+
+		combiner_type m_combiner;
+		// clone() shares the table, which changes how it holds the slots,
+		// not which slots it holds
+		mutable SlotTable<slot_type> m_slots;
+		waiter_type *m_waiters = nullptr;
+		ConnectionAnchor *m_anchor = nullptr;
+	};
+
+	/*******************************************************************************
+	 *                               StaticSignal
+	 *******************************************************************************/
+
+	// Signal whose slots are fixed at compile time. Each slot is a function
+	// pointer or a pointer to a callable object with static storage duration,
+	// and emission expands to direct calls the compiler can inline.
+	template <typename Signature, typename Combiner, auto... Slots>
+	class StaticSignal;
+
+	template <typename R, typename... Args, typename Combiner, auto... Slots>
+	class StaticSignal<R(Args...), Combiner, Slots...>
+	{
+
+	public:
+		using combiner_type = Combiner;
+		using result_type = typename Combiner::result_type;
+		using signature_type = R(Args...);
+
+		StaticSignal(Combiner combiner = Combiner())
+			: m_combiner(std::move(combiner))
+		{
+		}
+
+		static constexpr std::size_t slotCount()
+		{
+			return sizeof...(Slots);
+		}
+
+		template <typename... EmitArgs, typename = std::enable_if_t<sizeof...(EmitArgs) == sizeof...(Args)>>
+		result_type emitSignal(EmitArgs &&...args)
+		{
+			return emitArguments(std::make_index_sequence<sizeof...(Slots)>(), adaptArgument<Args>(std::forward<EmitArgs>(args))...);
+		}
+
+	private:
+		template <std::size_t... I, typename... EmitArgs>
+		result_type emitArguments(std::index_sequence<I...>, EmitArgs &&...args)
+		{
+			if constexpr (std::is_void_v<result_type>)
+			{
+				(invokeSlot<Slots, I + 1 == sizeof...(Slots), EmitArgs...>(args...), ...);
+			}
+			else
+			{
+				combiner_type combiner = makeCombiner(m_combiner, sizeof...(Slots));
+				static_cast<void>((... && combineItem(combiner, invokeSlot<Slots, I + 1 == sizeof...(Slots), EmitArgs...>(args...))));
+				return combiner.result();
+			}
+		}
+
+		template <auto Slot, bool Last, typename... EmitArgs>
+		static R invokeSlot(std::remove_reference_t<EmitArgs> &...args)
+		{
+			if constexpr (Last && movesToLastSlot<signature_type, EmitArgs...>)
+			{
+				return call<Slot, last_argument_t<Args>...>(lastArgument<Args, EmitArgs>(args)...);
+			}
+			else
+			{
+				return call<Slot, shared_argument_t<Args>...>(sharedArgument<Args, EmitArgs>(args)...);
+			}
+		}
+
+		// A slot is either callable itself or points to a callable object
+		template <auto Slot>
+		static decltype(auto) target()
+		{
+			if constexpr (std::is_pointer_v<decltype(Slot)> && !std::is_function_v<std::remove_pointer_t<decltype(Slot)>>)
+			{
+				static_assert(std::is_invocable_r_v<R, decltype(*Slot), Args...>, "slot is not callable with the signal signature");
+				static_assert(takesUniqueArguments<R, decltype(*Slot), Args...>, "slots take the arguments that cannot be copied by const reference");
+				return *Slot;
+			}
+			else
+			{
+				static_assert(std::is_invocable_r_v<R, decltype(Slot), Args...>, "slot is not callable with the signal signature");
+				static_assert(takesUniqueArguments<R, decltype(Slot), Args...>, "slots take the arguments that cannot be copied by const reference");
+				return Slot;
+			}
+		}
+
+		template <auto Slot, typename... Params>
+		static R call(Params... params)
+		{
+			if constexpr (std::is_invocable_r_v<R, decltype(target<Slot>()), Params...>)
+			{
+				return static_cast<R>(std::invoke(target<Slot>(), static_cast<Params &&>(params)...));
+			}
+			else
+			{
+				return static_cast<R>(std::invoke(target<Slot>(), rvalueArgument<Args, Params>(params)...));
+			}
+		}
+
 		combiner_type m_combiner;
-		std::map<std::size_t, std::function<signature_type>> m_slots;
-		std::size_t m_id;
 	};
 
 }
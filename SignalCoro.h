@@ -0,0 +1,423 @@
+#ifndef SIGNAL_CORO_H
+#define SIGNAL_CORO_H
+
+#include "Signal.h"
+#include "Future.h"
+
+#if !defined(__cpp_impl_coroutine)
+#error "SignalCoro.h requires C++20 coroutines"
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sig
+{
+	/*******************************************************************************
+	 *                               Task
+	 *******************************************************************************/
+
+	template <typename T>
+	class TaskResult
+	{
+	public:
+		template <typename U>
+		void return_value(U &&value)
+		{
+			m_value.emplace(std::forward<U>(value));
+		}
+
+		void unhandled_exception() noexcept
+		{
+			m_error = std::current_exception();
+		}
+
+		T take()
+		{
+			if (m_error)
+			{
+				std::rethrow_exception(m_error);
+			}
+			return std::move(*m_value);
+		}
+
+	private:
+		std::optional<T> m_value;
+		std::exception_ptr m_error;
+	};
+
+	template <>
+	class TaskResult<void>
+	{
+	public:
+		void return_void() noexcept
+		{
+		}
+
+		void unhandled_exception() noexcept
+		{
+			m_error = std::current_exception();
+		}
+
+		void take()
+		{
+			if (m_error)
+			{
+				std::rethrow_exception(m_error);
+			}
+		}
+
+	private:
+		std::exception_ptr m_error;
+	};
+
+	// Lazy coroutine: the body starts when the task is awaited, and resumes
+	// the awaiting coroutine directly when done, without going through a
+	// scheduler. Awaiting a task moves its result out, so it is awaited once.
+	// Outside of coroutines, spawn() starts it and returns a Future.
+	template <typename T = void>
+	class [[nodiscard]] Task
+	{
+		static_assert(!std::is_reference_v<T>, "tasks return results by value");
+
+	public:
+		class promise_type : public TaskResult<T>
+		{
+		public:
+			Task get_return_object() noexcept
+			{
+				return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+
+			std::suspend_always initial_suspend() noexcept
+			{
+				return {};
+			}
+
+			auto final_suspend() noexcept
+			{
+				struct Resume
+				{
+					bool await_ready() noexcept
+					{
+						return false;
+					}
+
+					std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+					{
+						std::coroutine_handle<> continuation = handle.promise().m_continuation;
+						return continuation ? continuation : std::noop_coroutine();
+					}
+
+					void await_resume() noexcept
+					{
+					}
+				};
+				return Resume();
+			}
+
+		private:
+			friend class Task;
+
+			std::coroutine_handle<> m_continuation;
+		};
+
+		Task() noexcept = default;
+
+		Task(Task &&other) noexcept
+			: m_handle(std::exchange(other.m_handle, nullptr))
+		{
+		}
+
+		Task &operator=(Task &&other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				m_handle = std::exchange(other.m_handle, nullptr);
+			}
+			return *this;
+		}
+
+		~Task()
+		{
+			reset();
+		}
+
+		bool valid() const noexcept
+		{
+			return static_cast<bool>(m_handle);
+		}
+
+		auto operator co_await() noexcept
+		{
+			struct Start
+			{
+				bool await_ready() noexcept
+				{
+					return handle.done();
+				}
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+				{
+					handle.promise().m_continuation = awaiting;
+					return handle;
+				}
+
+				T await_resume()
+				{
+					return handle.promise().take();
+				}
+
+				std::coroutine_handle<promise_type> handle;
+			};
+			return Start{m_handle};
+		}
+
+	private:
+		explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+			: m_handle(handle)
+		{
+		}
+
+		void reset() noexcept
+		{
+			if (m_handle)
+			{
+				m_handle.destroy();
+				m_handle = nullptr;
+			}
+		}
+
+		std::coroutine_handle<promise_type> m_handle;
+	};
+
+	// Coroutine running as soon as it is called and freeing itself at the end
+	struct DetachedTask
+	{
+		struct promise_type
+		{
+			DetachedTask get_return_object() noexcept
+			{
+				return {};
+			}
+
+			std::suspend_never initial_suspend() noexcept
+			{
+				return {};
+			}
+
+			std::suspend_never final_suspend() noexcept
+			{
+				return {};
+			}
+
+			void return_void() noexcept
+			{
+			}
+
+			void unhandled_exception() noexcept
+			{
+				std::terminate();
+			}
+		};
+	};
+
+	template <typename T>
+	DetachedTask runDetached(Task<T> task, Promise<T> promise)
+	{
+		try
+		{
+			if constexpr (std::is_void_v<T>)
+			{
+				co_await task;
+				promise.setValue();
+			}
+			else
+			{
+				promise.setValue(co_await task);
+			}
+		}
+		catch (...)
+		{
+			promise.setException(std::current_exception());
+		}
+	}
+
+	// Runs task on the calling thread up to its first suspension; the
+	// future completes when it finishes, wherever it is resumed.
+	template <typename T>
+	Future<T> spawn(Task<T> task)
+	{
+		Promise<T> promise;
+		Future<T> future = promise.getFuture();
+		runDetached(std::move(task), std::move(promise));
+		return future;
+	}
+
+	/*******************************************************************************
+	 *                               NextEmission
+	 *******************************************************************************/
+
+	// Awaiter of Signal::next(). Resumes with nothing, the argument, or a
+	// tuple of the arguments, depending on how many the signature has. Once
+	// waiting, it follows the signal when it is moved or swapped. The
+	// awaiting coroutine must not be destroyed during an emission of the
+	// signal, nor outlive the signal while waiting.
+	template <typename R, typename... Args, typename Combiner, std::size_t SlotBufferSize>
+	class NextEmission<Signal<R(Args...), Combiner, SlotBufferSize>> : private NextWaiter<Args...>
+	{
+		static_assert((... && std::is_copy_constructible_v<std::decay_t<Args>>), "next() copies the emitted arguments");
+
+	public:
+		using signal_type = Signal<R(Args...), Combiner, SlotBufferSize>;
+
+		explicit NextEmission(signal_type &signal) noexcept
+			: m_signal(signal)
+		{
+			this->receive = &receiveArguments;
+			this->resume = &resumeAwaiting;
+		}
+
+		NextEmission(const NextEmission &) = delete;
+		NextEmission &operator=(const NextEmission &) = delete;
+
+		~NextEmission()
+		{
+			if (m_waiting)
+			{
+				static_cast<signal_type *>(this->signal)->removeWaiter(this);
+			}
+		}
+
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> awaiting)
+		{
+			m_awaiting = awaiting;
+			m_signal.addWaiter(this);
+			m_waiting = true;
+		}
+
+		auto await_resume()
+		{
+			if constexpr (sizeof...(Args) == 1)
+			{
+				return std::get<0>(std::move(*m_arguments));
+			}
+			else if constexpr (sizeof...(Args) > 1)
+			{
+				return std::move(*m_arguments);
+			}
+		}
+
+	private:
+		using waiter_type = NextWaiter<Args...>;
+
+		static void receiveArguments(waiter_type *waiter, shared_argument_t<Args>... args)
+		{
+			NextEmission *self = static_cast<NextEmission *>(waiter);
+			self->m_waiting = false;
+			self->m_arguments.emplace(args...);
+		}
+
+		static void resumeAwaiting(waiter_type *waiter)
+		{
+			static_cast<NextEmission *>(waiter)->m_awaiting.resume();
+		}
+
+		signal_type &m_signal;
+		std::coroutine_handle<> m_awaiting;
+		std::optional<std::tuple<std::decay_t<Args>...>> m_arguments;
+		bool m_waiting = false;
+	};
+
+	/*******************************************************************************
+	 *                               AwaitCombiner
+	 *******************************************************************************/
+
+	template <typename Combiner>
+	struct CombinedValue
+	{
+		using type = void;
+	};
+
+	template <template <typename> class CombinerTemplate, typename T>
+	struct CombinedValue<CombinerTemplate<T>>
+	{
+		using type = T;
+	};
+
+	// Combiner for coroutine slots returning Task<T>. The emission only
+	// collects the tasks; awaiting the result runs them one after the other
+	// in connection order and feeds their results to Combiner, so a combiner
+	// stopping early leaves the remaining slot bodies unstarted. Slots should
+	// take their arguments by value, as the bodies run after the emission.
+	template <typename Combiner, typename T = typename CombinedValue<Combiner>::type>
+	class AwaitCombiner
+	{
+	public:
+		using result_type = Task<typename Combiner::result_type>;
+
+		AwaitCombiner(Combiner combiner = Combiner())
+			: m_combiner(std::move(combiner))
+		{
+		}
+
+		// The collected tasks cannot be copied
+		AwaitCombiner(const AwaitCombiner &) = delete;
+		AwaitCombiner(AwaitCombiner &&) = default;
+
+		// Combiner for a new emission, with a fresh copy of Combiner
+		AwaitCombiner fresh() const
+		{
+			return AwaitCombiner(freshCombiner(m_combiner));
+		}
+
+		void reserve(std::size_t count)
+		{
+			m_tasks.reserve(count);
+		}
+
+		void combine(Task<T> task)
+		{
+			m_tasks.push_back(std::move(task));
+		}
+
+		result_type result()
+		{
+			return awaitAll(std::move(m_combiner), std::move(m_tasks));
+		}
+
+	private:
+		static result_type awaitAll(Combiner combiner, std::vector<Task<T>> tasks)
+		{
+			for (Task<T> &task : tasks)
+			{
+				if constexpr (std::is_void_v<T>)
+				{
+					co_await task;
+				}
+				else if (!combineItem(combiner, co_await task))
+				{
+					break;
+				}
+			}
+			co_return combiner.result();
+		}
+
+		Combiner m_combiner;
+		std::vector<Task<T>> m_tasks;
+	};
+
+}
+
+#endif // SIGNAL_CORO_H
@@ -0,0 +1,726 @@
+#include "Signal.h"
+#include "ConcurrentSignal.h"
+#include "LockFreeSignal.h"
+#include "Executor.h"
+#include "Future.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/********************************************************
+ *                  Benchmark helpers
+ ********************************************************/
+template <typename T>
+void doNotOptimize(T &value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+template <typename F>
+void benchmark(const char *name, std::size_t iterations, F &&f)
+{
+    f();
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        f();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    std::printf("%-48s %12.2f ns/op\n", name, ns);
+}
+
+// Runs f iterations times on each thread and reports the total throughput
+template <typename F>
+void benchmarkThreads(const char *name, unsigned threads, std::size_t iterations, F &&f)
+{
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> start{false};
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]() {
+            ++ready;
+            while (!start)
+            {
+                std::this_thread::yield();
+            }
+            for (std::size_t i = 0; i < iterations; ++i)
+            {
+                f();
+            }
+        });
+    }
+    while (ready != threads)
+    {
+        std::this_thread::yield();
+    }
+    auto begin = std::chrono::steady_clock::now();
+    start = true;
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    std::printf("%-36s %3u threads %10.2f Mop/s\n", name, threads, threads * iterations / seconds / 1e6);
+}
+
+std::vector<unsigned> threadCounts(unsigned maximum)
+{
+    std::vector<unsigned> counts;
+    unsigned limit = std::max(4u, std::min(maximum, std::thread::hardware_concurrency()));
+    for (unsigned threads = 1; threads <= limit; threads *= 2)
+    {
+        counts.push_back(threads);
+    }
+    return counts;
+}
+
+/********************************************************
+ *                  Slot targets
+ ********************************************************/
+static int counter = 0;
+
+__attribute__((noinline)) void freeSlot(int value)
+{
+    counter += value;
+}
+
+__attribute__((noinline)) void emptySlot(int value)
+{
+    asm volatile("" : : "g"(value));
+}
+
+class Receiver
+{
+public:
+    __attribute__((noinline)) void onValue(int value)
+    {
+        m_sum += value;
+    }
+
+    int m_sum = 0;
+};
+
+/********************************************************
+ *                  Delegates
+ ********************************************************/
+constexpr std::size_t slotCount = 100;
+constexpr std::size_t emitCount = 200000;
+
+void benchDelegates()
+{
+    std::printf("\n-- emit to %zu slots --\n", slotCount);
+    std::vector<Receiver> receivers(slotCount);
+
+    {
+        std::vector<std::function<void(int)>> slots;
+        for (std::size_t i = 0; i < slotCount; ++i)
+        {
+            slots.emplace_back([&receiver = receivers[i]](int value) { receiver.onValue(value); });
+        }
+        benchmark("std::function vector (reference)", emitCount, [&]() {
+            for (auto &slot : slots)
+            {
+                slot(1);
+            }
+        });
+    }
+    {
+        sig::Signal<void(int)> signal;
+        for (std::size_t i = 0; i < slotCount; ++i)
+        {
+            signal.connectSlot([&receiver = receivers[i]](int value) { receiver.onValue(value); });
+        }
+        benchmark("member function through lambda", emitCount, [&]() { signal.emitSignal(1); });
+    }
+    {
+        sig::Signal<void(int)> signal;
+        for (std::size_t i = 0; i < slotCount; ++i)
+        {
+            signal.connectSlot<&Receiver::onValue>(&receivers[i]);
+        }
+        benchmark("member function delegate", emitCount, [&]() { signal.emitSignal(1); });
+    }
+    {
+        sig::Signal<void(int)> signal;
+        for (std::size_t i = 0; i < slotCount; ++i)
+        {
+            signal.connectSlot(&freeSlot);
+        }
+        benchmark("free function pointer", emitCount, [&]() { signal.emitSignal(1); });
+    }
+    {
+        sig::Signal<void(int)> signal;
+        for (std::size_t i = 0; i < slotCount; ++i)
+        {
+            signal.connectSlot<&freeSlot>();
+        }
+        benchmark("free function delegate", emitCount, [&]() { signal.emitSignal(1); });
+    }
+    doNotOptimize(counter);
+}
+
+/********************************************************
+ *                  StaticSignal
+ ********************************************************/
+void benchStaticSignal()
+{
+    std::printf("\n-- emit to 4 fixed slots --\n");
+    {
+        sig::Signal<void(int)> signal;
+        signal.connectSlot<&freeSlot>();
+        signal.connectSlot<&freeSlot>();
+        signal.connectSlot<&freeSlot>();
+        signal.connectSlot<&freeSlot>();
+        benchmark("Signal with delegates", emitCount * 10, [&]() { signal.emitSignal(1); });
+    }
+    {
+        sig::StaticSignal<void(int), sig::DiscardCombiner, &freeSlot, &freeSlot, &freeSlot, &freeSlot> signal;
+        benchmark("StaticSignal", emitCount * 10, [&]() { signal.emitSignal(1); });
+    }
+    doNotOptimize(counter);
+}
+
+/********************************************************
+ *                  Result buffers
+ ********************************************************/
+__attribute__((noinline)) int valueSlot(int value)
+{
+    return value + 1;
+}
+
+void benchResultBuffers()
+{
+    std::printf("\n-- collect results of %zu slots --\n", slotCount);
+    sig::Signal<int(int), sig::VectorCombiner<int>> signal;
+    for (std::size_t i = 0; i < slotCount; ++i)
+    {
+        signal.connectSlot<&valueSlot>();
+    }
+    benchmark("VectorCombiner", emitCount, [&]() {
+        auto results = signal.emitSignal(1);
+        doNotOptimize(results);
+    });
+    std::vector<int> results;
+    benchmark("emitInto reused vector", emitCount, [&]() {
+        signal.emitInto(results, 1);
+        doNotOptimize(results);
+    });
+    std::vector<int> buffer(slotCount);
+    benchmark("emitInto raw buffer", emitCount, [&]() {
+        signal.emitInto(buffer.data(), 1);
+        doNotOptimize(buffer);
+    });
+}
+
+/********************************************************
+ *                  Concurrent emission
+ ********************************************************/
+void benchConcurrentEmission()
+{
+    constexpr std::size_t slots = 10;
+    constexpr std::size_t emits = 100000;
+    std::printf("\n-- concurrent emission to %zu slots --\n", slots);
+
+    sig::Signal<void(int)> signal;
+    std::mutex mutex;
+    sig::ConcurrentSignal<void(int)> concurrentSignal;
+    for (std::size_t i = 0; i < slots; ++i)
+    {
+        signal.connectSlot<&emptySlot>();
+        concurrentSignal.connectSlot<&emptySlot>();
+    }
+    for (unsigned threads : threadCounts(64))
+    {
+        benchmarkThreads("mutex-wrapped Signal", threads, emits, [&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            signal.emitSignal(1);
+        });
+        benchmarkThreads("ConcurrentSignal", threads, emits, [&]() { concurrentSignal.emitSignal(1); });
+    }
+}
+
+/********************************************************
+ *                  Subscription churn
+ ********************************************************/
+// Signal as a mutex-wrapped ordered map, for reference
+class MutexMapSignal
+{
+public:
+    std::size_t connectSlot(std::function<void(int)> slot)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_slots.emplace(m_nextId, std::move(slot));
+        return m_nextId++;
+    }
+
+    void disconnectSlot(std::size_t id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_slots.erase(id);
+    }
+
+    void emitSignal(int value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &slot : m_slots)
+        {
+            slot.second(value);
+        }
+    }
+
+private:
+    std::mutex m_mutex;
+    std::map<std::size_t, std::function<void(int)>> m_slots;
+    std::size_t m_nextId = 0;
+};
+
+// One in every emitsPerChurn operations connects and disconnects a slot,
+// the others emit
+template <typename SignalType>
+void benchChurn(const char *name, unsigned threads, std::size_t emitsPerChurn)
+{
+    constexpr std::size_t slots = 100;
+    constexpr std::size_t operations = 20000;
+    SignalType signal;
+    for (std::size_t i = 0; i < slots; ++i)
+    {
+        signal.connectSlot(&emptySlot);
+    }
+    benchmarkThreads(name, threads, operations, [&]() {
+        thread_local std::size_t operation = 0;
+        if (++operation % emitsPerChurn == 0)
+        {
+            signal.disconnectSlot(signal.connectSlot(&emptySlot));
+        }
+        else
+        {
+            signal.emitSignal(1);
+        }
+    });
+}
+
+void benchSubscriptionChurn()
+{
+    for (std::size_t emitsPerChurn : {1, 10, 100})
+    {
+        std::printf("\n-- 100 slots, one churn every %zu operations --\n", emitsPerChurn);
+        for (unsigned threads : threadCounts(64))
+        {
+            benchChurn<MutexMapSignal>("mutex-wrapped std::map", threads, emitsPerChurn);
+            benchChurn<sig::ConcurrentSignal<void(int)>>("ConcurrentSignal (snapshots)", threads, emitsPerChurn);
+            benchChurn<sig::LockFreeSignal<void(int)>>("LockFreeSignal (hazard pointers)", threads, emitsPerChurn);
+        }
+    }
+}
+
+/********************************************************
+ *                  Subscriber churn
+ ********************************************************/
+// Replaces one subscriber out of many per iteration, the oldest first
+void benchDisconnect()
+{
+    constexpr std::size_t subscribers = 1000;
+    std::printf("\n-- replace one of %zu subscribers --\n", subscribers);
+
+    std::map<std::size_t, std::function<void(int)>> map;
+    std::deque<std::size_t> mapIds;
+    std::size_t nextId = 0;
+    for (std::size_t i = 0; i < subscribers; ++i)
+    {
+        map.emplace(nextId, [](int) {});
+        mapIds.push_back(nextId++);
+    }
+    benchmark("std::map of std::function, by id", emitCount, [&]() {
+        map.erase(mapIds.front());
+        mapIds.pop_front();
+        map.emplace(nextId, [](int) {});
+        mapIds.push_back(nextId++);
+    });
+
+    sig::Signal<void(int)> signal;
+    std::deque<std::size_t> ids;
+    for (std::size_t i = 0; i < subscribers; ++i)
+    {
+        ids.push_back(signal.connectSlot([](int) {}));
+    }
+    benchmark("Signal, disconnectSlot(id)", emitCount, [&]() {
+        signal.disconnectSlot(ids.front());
+        ids.pop_front();
+        ids.push_back(signal.connectSlot([](int) {}));
+    });
+
+    sig::Signal<void(int)> scopedSignal;
+    std::deque<sig::ScopedConnection> connections;
+    for (std::size_t i = 0; i < subscribers; ++i)
+    {
+        connections.emplace_back(scopedSignal.connect([](int) {}));
+    }
+    benchmark("Signal, ScopedConnection", emitCount, [&]() {
+        connections.pop_front();
+        connections.emplace_back(scopedSignal.connect([](int) {}));
+    });
+}
+
+// Wiring a service at startup and tearing it down at shutdown
+void benchWiring()
+{
+    constexpr std::size_t subscribers = 10000;
+    constexpr std::size_t rounds = 200;
+    std::printf("\n-- connect then disconnect %zu slots --\n", subscribers);
+    std::vector<void (*)(int)> slots(subscribers, &freeSlot);
+
+    benchmark("std::map of std::function, one by one", rounds, [&]() {
+        std::map<std::size_t, std::function<void(int)>> map;
+        std::size_t nextId = 0;
+        for (auto slot : slots)
+        {
+            map.emplace(nextId++, slot);
+        }
+        for (std::size_t id = 0; id < subscribers; ++id)
+        {
+            map.erase(id);
+        }
+    });
+
+    std::vector<std::size_t> ids(subscribers);
+    benchmark("Signal, connectSlot and disconnectSlot", rounds, [&]() {
+        sig::Signal<void(int)> signal;
+        for (std::size_t i = 0; i < subscribers; ++i)
+        {
+            ids[i] = signal.connectSlot(slots[i]);
+        }
+        for (std::size_t id : ids)
+        {
+            signal.disconnectSlot(id);
+        }
+    });
+
+    benchmark("Signal, connectSlots and disconnectAll", rounds, [&]() {
+        sig::Signal<void(int)> signal;
+        signal.connectSlots(slots, ids.begin());
+        signal.disconnectAll();
+    });
+}
+
+// Stamping out signals from a wired prototype
+void benchClone()
+{
+    std::printf("\n-- new signal with %zu slots capturing a string --\n", slotCount);
+    auto wire = [](sig::Signal<void(int)> &signal)
+    {
+        for (std::size_t i = 0; i < slotCount; ++i)
+        {
+            std::string name = "handler number " + std::to_string(i) + " of the prototype";
+            signal.connectSlot([name](int value) { freeSlot(value + static_cast<int>(name.size())); });
+        }
+    };
+    benchmark("connect every slot", emitCount / 10, [&]() {
+        sig::Signal<void(int)> signal;
+        wire(signal);
+        doNotOptimize(signal);
+    });
+
+    sig::Signal<void(int)> prototype;
+    wire(prototype);
+    sig::Signal<void(int)> clone = prototype.clone();
+    benchmark("clone()", emitCount / 10, [&]() {
+        sig::Signal<void(int)> copy = prototype.clone();
+        doNotOptimize(copy);
+    });
+
+    // a change gives the clone a table of its own, calling the shared slots
+    sig::Signal<void(int)> changed = prototype.clone();
+    changed.disconnectSlot(changed.connectSlot([](int) {}));
+
+    sig::Signal<void(int)> owner;
+    wire(owner);
+    benchmark("emit, owned slots", emitCount, [&]() { owner.emitSignal(1); });
+    benchmark("emit, shared table", emitCount, [&]() { clone.emitSignal(1); });
+    benchmark("emit, shared slots", emitCount, [&]() { changed.emitSignal(1); });
+}
+
+// Emission cost of weak_ptr tracking, against untracked slots
+void benchTrackedSlots()
+{
+    std::printf("\n-- emit to %zu slots, tracked or not --\n", slotCount);
+    sig::Signal<void(int)> plain;
+    sig::Signal<void(int)> tracked;
+    auto object = std::make_shared<int>(0);
+    for (std::size_t i = 0; i < slotCount; ++i)
+    {
+        plain.connectSlot<&freeSlot>();
+        tracked.connectTracked([](int value) { freeSlot(value); }, object);
+    }
+    benchmark("untracked slots", emitCount, [&]() { plain.emitSignal(1); });
+    benchmark("slots tracking a weak_ptr", emitCount, [&]() { tracked.emitSignal(1); });
+}
+
+void benchBlockedSlots()
+{
+    std::printf("\n-- emit to %zu slots, 9 in 10 blocked --\n", slotCount);
+    sig::Signal<void(int)> none;
+    sig::Signal<void(int)> blocked;
+    sig::Signal<void(int)> flagged;
+    std::vector<char> enabled(slotCount);
+    for (std::size_t i = 0; i < slotCount; ++i)
+    {
+        none.connectSlot<&freeSlot>();
+        std::size_t id = blocked.connectSlot<&freeSlot>();
+        if (i % 10 != 0)
+        {
+            blocked.block(id);
+        }
+        enabled[i] = i % 10 == 0;
+        flagged.connectSlot([&enabled, i](int value)
+                            {
+            if (enabled[i])
+            {
+                freeSlot(value);
+            } });
+    }
+    benchmark("no slot blocked", emitCount, [&]() { none.emitSignal(1); });
+    benchmark("blocked, skipped by bit scan", emitCount, [&]() { blocked.emitSignal(1); });
+    benchmark("flag checked in every slot", emitCount, [&]() { flagged.emitSignal(1); });
+}
+
+/********************************************************
+ *                  Queued delivery
+ ********************************************************/
+// Hand-rolled queued connection target: mutex-protected std::deque
+class MutexDequeLoop
+{
+public:
+    template <typename F>
+    void post(F &&task)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.emplace_back(std::forward<F>(task));
+    }
+
+    std::size_t drain()
+    {
+        std::deque<std::function<void()>> tasks;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            tasks.swap(m_tasks);
+        }
+        for (auto &task : tasks)
+        {
+            task();
+        }
+        return tasks.size();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<std::function<void()>> m_tasks;
+};
+
+// Producer threads emit, one consumer thread drains until every delivery ran
+template <typename Loop>
+void benchQueued(const char *name, unsigned producers)
+{
+    constexpr std::size_t emits = 200000;
+    Loop loop;
+    sig::Signal<void(int)> signal;
+    std::size_t received = 0;
+    signal.connectSlot(loop, [&received](int value) { received += value; });
+
+    std::atomic<bool> start{false};
+    std::thread consumer([&]() {
+        while (!start)
+        {
+            std::this_thread::yield();
+        }
+        while (received != producers * emits)
+        {
+            if (loop.drain() == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < producers; ++t)
+    {
+        threads.emplace_back([&]() {
+            while (!start)
+            {
+                std::this_thread::yield();
+            }
+            for (std::size_t i = 0; i < emits; ++i)
+            {
+                signal.emitSignal(1);
+            }
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start = true;
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    consumer.join();
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - begin).count() / (producers * emits);
+    std::printf("%-36s %3u producers %9.2f ns/delivery\n", name, producers, ns);
+}
+
+// Post and drain batches on one thread: the handoff cost without scheduling
+template <typename Loop>
+void benchQueuedBatches(const char *name)
+{
+    constexpr std::size_t batch = 256;
+    Loop loop;
+    sig::Signal<void(int)> signal;
+    std::size_t received = 0;
+    signal.connectSlot(loop, [&received](int value) { received += value; });
+    benchmark(name, emitCount / batch, [&]() {
+        for (std::size_t i = 0; i < batch; ++i)
+        {
+            signal.emitSignal(1);
+        }
+        loop.drain();
+    });
+    doNotOptimize(received);
+}
+
+void benchQueuedDelivery()
+{
+    std::printf("\n-- queued delivery, batches of 256 on one thread --\n");
+    benchQueuedBatches<MutexDequeLoop>("mutex-protected std::deque");
+    benchQueuedBatches<sig::EventLoop>("EventLoop (MPSC ring)");
+
+    std::printf("\n-- queued cross-thread delivery --\n");
+    for (unsigned producers : {1u, 2u, 4u})
+    {
+        benchQueued<MutexDequeLoop>("mutex-protected std::deque", producers);
+        benchQueued<sig::EventLoop>("EventLoop (MPSC ring)", producers);
+    }
+}
+
+/********************************************************
+ *                  Parallel emission
+ ********************************************************/
+__attribute__((noinline)) int heavySlot(int value)
+{
+    unsigned hash = static_cast<unsigned>(value);
+    for (int i = 0; i < 20000; ++i)
+    {
+        hash = hash * 2654435761u + static_cast<unsigned>(i);
+    }
+    return static_cast<int>(hash);
+}
+
+void benchParallelEmission()
+{
+    constexpr std::size_t slots = 48;
+    constexpr std::size_t emits = 200;
+    std::printf("\n-- fan-out to %zu CPU-heavy slots --\n", slots);
+
+    sig::Signal<int(int), sig::VectorCombiner<int>> signal;
+    for (std::size_t i = 0; i < slots; ++i)
+    {
+        signal.connectSlot<&heavySlot>();
+    }
+    benchmark("emitSignal (serial)", emits, [&]() {
+        auto results = signal.emitSignal(1);
+        doNotOptimize(results);
+    });
+    for (unsigned threads : threadCounts(64))
+    {
+        // the calling thread is one of the threads
+        sig::ThreadPool pool(threads - 1);
+        char name[64];
+        std::snprintf(name, sizeof(name), "emitParallel, %u threads", threads);
+        benchmark(name, emits, [&]() {
+            auto results = signal.emitParallel(pool, 1);
+            doNotOptimize(results);
+        });
+    }
+}
+
+/********************************************************
+ *                  Asynchronous emission
+ ********************************************************/
+void benchAsyncEmission()
+{
+    constexpr std::size_t batch = 256;
+    std::printf("\n-- futures --\n");
+    benchmark("std::promise / std::future", emitCount, []() {
+        std::promise<int> promise;
+        std::future<int> future = promise.get_future();
+        promise.set_value(1);
+        int value = future.get();
+        doNotOptimize(value);
+    });
+    benchmark("sig::Promise / sig::Future", emitCount, []() {
+        sig::Promise<int> promise;
+        sig::Future<int> future = promise.getFuture();
+        promise.setValue(1);
+        int value = future.get();
+        doNotOptimize(value);
+    });
+
+    std::printf("\n-- emitAsync, %zu in flight on an event loop --\n", batch);
+    sig::EventLoop loop;
+    sig::Signal<void(int)> signal;
+    std::size_t received = 0;
+    signal.connectSlot(loop, [&received](int value) { received += value; });
+    std::vector<sig::Future<void>> futures;
+    futures.reserve(batch);
+    benchmark("256 emitAsync + drain + get", emitCount / batch, [&]() {
+        for (std::size_t i = 0; i < batch; ++i)
+        {
+            futures.push_back(signal.emitAsync(1));
+        }
+        loop.drain();
+        for (sig::Future<void> &future : futures)
+        {
+            future.get();
+        }
+        futures.clear();
+    });
+    doNotOptimize(received);
+
+    std::printf("\n-- emitAsync round trip through a pool thread --\n");
+    sig::ThreadPool pool(1);
+    sig::Signal<int(int), sig::SumCombiner<int>> request;
+    request.connectSlot<&valueSlot>();
+    benchmark("emitAsync(pool).get()", emitCount / 100, [&]() {
+        int value = request.emitAsync(pool, 1).get();
+        doNotOptimize(value);
+    });
+}
+
+int main()
+{
+    benchDelegates();
+    benchStaticSignal();
+    benchResultBuffers();
+    benchConcurrentEmission();
+    benchSubscriptionChurn();
+    benchDisconnect();
+    benchWiring();
+    benchClone();
+    benchTrackedSlots();
+    benchBlockedSlots();
+    benchQueuedDelivery();
+    benchParallelEmission();
+    benchAsyncEmission();
+    return 0;
+}
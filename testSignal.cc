@@ -1,8 +1,49 @@
 #include "Signal.h"
+#include "ConcurrentSignal.h"
+#include "LockFreeSignal.h"
+#include "Executor.h"
+#include "Future.h"
 
 #include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <vector>
 
+/********************************************************
+ *          Global allocation counter
+ ********************************************************/
+static std::atomic<std::size_t> allocationCount{0};
+
+void *operator new(std::size_t size)
+{
+    ++allocationCount;
+    if (void *ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
 /********************************************************
  *          Structure with an impossible copy
  ********************************************************/
@@ -25,6 +66,34 @@ public:
     int int_no_copy;
 };
 
+/********************************************************
+ *          Structure counting its copies and moves
+ ********************************************************/
+struct CopyCounter
+{
+    CopyCounter() = default;
+    CopyCounter(const CopyCounter &)
+    {
+        ++copies;
+    }
+    CopyCounter(CopyCounter &&) noexcept
+    {
+        ++moves;
+    }
+    CopyCounter &operator=(const CopyCounter &) = default;
+    CopyCounter &operator=(CopyCounter &&) = default;
+
+    static void reset()
+    {
+        copies = 0;
+        moves = 0;
+    }
+
+    static inline int copies = 0;
+    static inline int moves = 0;
+    std::vector<int> payload;
+};
+
 /********************************************************
  *                    FirstCombiner
  ********************************************************/
@@ -82,6 +151,31 @@ public:
 
 
 
+/********************************************************
+ *                Receiver class
+ ********************************************************/
+class Receiver
+{
+public:
+    void setValue(int value)
+    {
+        m_value = value;
+    }
+
+    int value() const
+    {
+        return m_value;
+    }
+
+    int add(int value) const
+    {
+        return m_value + value;
+    }
+
+private:
+    int m_value = 0;
+};
+
 /********************************************************
  *                Callback functions
  ********************************************************/
@@ -143,13 +237,13 @@ std::unique_ptr<int> callback_11()
     return ptr;
 }
 
-int callback_12(NoCopy nc)
+int callback_12(const NoCopy &nc)
 {
     int value = nc.int_no_copy * 5;
     return value;
 }
 
-int callback_13(NoCopy nc)
+int callback_13(const NoCopy &nc)
 {
     int value = nc.int_no_copy * 6;
     return value;
@@ -159,6 +253,11 @@ int callback_14(int i1, int i2){
     return i1+i2;
 }
 
+int callback_15(int i)
+{
+    return i * 2;
+}
+
 
 /********************************************************
  *                      Tests
@@ -286,6 +385,201 @@ TEST(disconnectSlot, KeepOtherAccess)
     EXPECT_EQ(res3, 9);
 }
 
+// A disconnected id does not reach a slot connected after it
+TEST(disconnectSlot, StaleIdAfterReuse)
+{
+    sig::Signal<void(int)> signal;
+
+    int res1 = 0;
+    std::size_t id1 = signal.connectSlot([&res1](int i){ res1 = i; });
+    signal.disconnectSlot(id1);
+
+    int res2 = 0;
+    std::size_t id2 = signal.connectSlot([&res2](int i){ res2 = i; });
+    EXPECT_NE(id1, id2);
+
+    signal.disconnectSlot(id1);
+    signal.emitSignal(5);
+    EXPECT_EQ(res1, 0);
+    EXPECT_EQ(res2, 5);
+    EXPECT_EQ(signal.slotCount(), 1u);
+}
+
+// Connection order is kept when many slots are disconnected
+TEST(disconnectSlot, KeepOrder)
+{
+    sig::Signal<int(), sig::VectorCombiner<int>> signal;
+    std::vector<std::size_t> ids;
+    for (int i = 0; i < 100; ++i)
+    {
+        ids.push_back(signal.connectSlot([i]() { return i; }));
+    }
+    for (int i = 0; i < 100; ++i)
+    {
+        if (i % 3 != 0)
+        {
+            signal.disconnectSlot(ids[i]);
+        }
+    }
+    signal.connectSlot([]() { return 100; });
+
+    std::vector<int> expect;
+    for (int i = 0; i < 100; i += 3)
+    {
+        expect.push_back(i);
+    }
+    expect.push_back(100);
+    EXPECT_EQ(signal.emitSignal(), expect);
+    EXPECT_EQ(signal.slotCount(), expect.size());
+}
+
+/**
+ * Slot function tests
+ */
+
+// A small lambda is stored inline
+TEST(slotFunction, NoAllocationForSmallLambda)
+{
+    int a = 1;
+    int b = 2;
+    std::size_t before = allocationCount;
+    sig::SlotFunction<int(int)> function([a, b](int x) { return a + b + x; });
+    EXPECT_EQ(allocationCount, before);
+    EXPECT_EQ(function(3), 6);
+}
+
+// A large capture falls back to the heap
+TEST(slotFunction, LargeCapture)
+{
+    std::array<int, 64> values{};
+    values[63] = 7;
+    auto lambda = [values]() { return values[63]; };
+    EXPECT_FALSE(sig::SlotFunction<int()>::storedInline<decltype(lambda)>());
+
+    sig::Signal<int(), sig::LastCombiner<int>> signal;
+    signal.connectSlot(lambda);
+    EXPECT_EQ(signal.emitSignal(), 7);
+}
+
+// The inline buffer size is configurable
+TEST(slotFunction, ConfigurableBuffer)
+{
+    std::array<int, 64> values{};
+    auto lambda = [values]() { return values[0]; };
+    EXPECT_TRUE((sig::SlotFunction<int(), sizeof(lambda)>::storedInline<decltype(lambda)>()));
+
+    sig::Signal<int(), sig::LastCombiner<int>, sizeof(lambda)> signal;
+    signal.connectSlot(lambda);
+    EXPECT_EQ(signal.emitSignal(), 0);
+}
+
+// Move-only captures can be connected
+TEST(slotFunction, MoveOnlyCapture)
+{
+    sig::Signal<int(), sig::LastCombiner<int>> signal;
+    auto ptr = std::make_unique<int>(42);
+    signal.connectSlot([ptr = std::move(ptr)]() { return *ptr; });
+    EXPECT_EQ(signal.emitSignal(), 42);
+}
+
+// Moving a slot function keeps its callable
+TEST(slotFunction, Move)
+{
+    sig::SlotFunction<int()> function([ptr = std::make_unique<int>(3)]() { return *ptr; });
+    sig::SlotFunction<int()> other(std::move(function));
+    EXPECT_FALSE(function);
+    EXPECT_TRUE(other);
+    EXPECT_EQ(other(), 3);
+}
+
+// A signal with a single slot does not allocate
+TEST(slotFunction, SingleSlotNoAllocation)
+{
+    int res = 0;
+    std::size_t before = allocationCount;
+    sig::Signal<void(int)> signal;
+    std::size_t id = signal.connectSlot([&res](int x) { res += x; });
+    signal.emitSignal(2);
+    signal.disconnectSlot(id);
+    signal.connectSlot([&res](int x) { res += x * 10; });
+    signal.emitSignal(3);
+    EXPECT_EQ(allocationCount, before);
+    EXPECT_EQ(res, 32);
+
+    signal.connectSlot([&res](int x) { res += x * 100; });
+    EXPECT_GT(allocationCount, before);
+    signal.emitSignal(1);
+    EXPECT_EQ(res, 142);
+}
+
+// A moved signal keeps its inline slot
+TEST(slotFunction, MoveSignal)
+{
+    sig::Signal<int(), sig::VectorCombiner<int>> signal;
+    signal.connectSlot(&callback_3);
+    sig::Signal<int(), sig::VectorCombiner<int>> other(std::move(signal));
+    other.connectSlot(&callback_4);
+    std::vector<int> expect = {1, 2};
+    EXPECT_EQ(other.emitSignal(), expect);
+}
+
+/**
+ * Delegate tests
+ */
+
+// Connect a free function known at compile time
+TEST(delegate, FreeFunction)
+{
+    sig::Signal<void(int &)> signal;
+    int res = 0;
+    signal.connectSlot<&callback_1>();
+    signal.emitSignal(res);
+    EXPECT_EQ(res, 1);
+}
+
+// Connect a member function bound to an object
+TEST(delegate, MemberFunction)
+{
+    sig::Signal<void(int)> signal;
+    Receiver receiver;
+    std::size_t id = signal.connectSlot<&Receiver::setValue>(&receiver);
+    signal.emitSignal(4);
+    EXPECT_EQ(receiver.value(), 4);
+
+    signal.disconnectSlot(id);
+    signal.emitSignal(5);
+    EXPECT_EQ(receiver.value(), 4);
+}
+
+// Connect a const member function on a const object
+TEST(delegate, ConstMemberFunction)
+{
+    sig::Signal<int(int), sig::VectorCombiner<int>> signal;
+    Receiver receiver;
+    receiver.setValue(10);
+    const Receiver &constReceiver = receiver;
+    signal.connectSlot<&Receiver::add>(&constReceiver);
+    signal.connectSlot<&callback_15>();
+    std::vector<int> expect = {13, 6};
+    EXPECT_EQ(signal.emitSignal(3), expect);
+}
+
+// Binding a delegate does not allocate
+TEST(delegate, NoAllocation)
+{
+    Receiver receiver;
+    std::size_t before = allocationCount;
+    auto function = sig::SlotFunction<void(int)>::bind<&Receiver::setValue>(&receiver);
+    auto other = sig::SlotFunction<void(int &)>::bind<&callback_1>();
+    EXPECT_EQ(allocationCount, before);
+
+    int res = 0;
+    function(6);
+    other(res);
+    EXPECT_EQ(receiver.value(), 6);
+    EXPECT_EQ(res, 1);
+}
+
 /**
  * Emit signal tests
  */
@@ -350,6 +644,129 @@ TEST(emitSignal, LambdaWithVector)
     EXPECT_EQ(sum, 6);
 }
 
+/**
+ * Argument copy tests
+ */
+
+// An lvalue argument is copied once per by-value slot
+TEST(argumentCopy, LvalueToValueSlots)
+{
+    sig::Signal<void(CopyCounter)> signal;
+    for (int i = 0; i < 3; ++i)
+    {
+        signal.connectSlot([](CopyCounter) {});
+    }
+    CopyCounter counter;
+    CopyCounter::reset();
+    signal.emitSignal(counter);
+    EXPECT_EQ(CopyCounter::copies, 3);
+    EXPECT_EQ(CopyCounter::moves, 0);
+}
+
+// An rvalue argument is moved into the last slot only
+TEST(argumentCopy, RvalueToValueSlots)
+{
+    sig::Signal<void(CopyCounter)> signal;
+    for (int i = 0; i < 3; ++i)
+    {
+        signal.connectSlot([](CopyCounter) {});
+    }
+    CopyCounter::reset();
+    signal.emitSignal(CopyCounter());
+    EXPECT_EQ(CopyCounter::copies, 2);
+    EXPECT_EQ(CopyCounter::moves, 1);
+}
+
+// Slots taking a const reference never copy
+TEST(argumentCopy, ConstRefSlots)
+{
+    sig::Signal<void(CopyCounter)> signal;
+    signal.connectSlot([](const CopyCounter &) {});
+    signal.connectSlot([](const CopyCounter &) {});
+    CopyCounter counter;
+    CopyCounter::reset();
+    signal.emitSignal(counter);
+    signal.emitSignal(std::move(counter));
+    EXPECT_EQ(CopyCounter::copies, 0);
+    EXPECT_EQ(CopyCounter::moves, 0);
+}
+
+// A slot taking an rvalue receives its own copy unless it is the last one
+TEST(argumentCopy, RvalueRefSlots)
+{
+    sig::Signal<void(CopyCounter)> signal;
+    signal.connectSlot([](CopyCounter &&) {});
+    signal.connectSlot([](CopyCounter &&) {});
+    CopyCounter::reset();
+    signal.emitSignal(CopyCounter());
+    EXPECT_EQ(CopyCounter::copies, 1);
+    EXPECT_EQ(CopyCounter::moves, 0);
+}
+
+// Disconnected slots at the end do not change which slot is last
+TEST(argumentCopy, LastAfterDisconnect)
+{
+    sig::Signal<void(CopyCounter)> signal;
+    signal.connectSlot([](CopyCounter) {});
+    signal.connectSlot([](CopyCounter) {});
+    std::size_t id = signal.connectSlot([](CopyCounter) {});
+    signal.disconnectSlot(id);
+    CopyCounter::reset();
+    signal.emitSignal(CopyCounter());
+    EXPECT_EQ(CopyCounter::copies, 1);
+    EXPECT_EQ(CopyCounter::moves, 1);
+}
+
+// Returned values reach the combiner without copies
+TEST(argumentCopy, VectorCombiner)
+{
+    sig::Signal<CopyCounter(CopyCounter), sig::VectorCombiner<CopyCounter>> signal;
+    signal.connectSlot([](const CopyCounter &c) { return c; });
+    signal.connectSlot([](CopyCounter c) { return c; });
+    CopyCounter::reset();
+    auto res = signal.emitSignal(CopyCounter());
+    EXPECT_EQ(res.size(), 2u);
+    EXPECT_EQ(CopyCounter::copies, 1);
+}
+
+TEST(argumentCopy, StaticSignal)
+{
+    static void (*const slot)(CopyCounter) = [](CopyCounter) {};
+    sig::StaticSignal<void(CopyCounter), sig::DiscardCombiner, &slot, &slot, &slot> signal;
+    CopyCounter counter;
+    CopyCounter::reset();
+    signal.emitSignal(counter);
+    EXPECT_EQ(CopyCounter::copies, 3);
+    CopyCounter::reset();
+    signal.emitSignal(std::move(counter));
+    EXPECT_EQ(CopyCounter::copies, 2);
+    EXPECT_EQ(CopyCounter::moves, 1);
+}
+
+// Non-const reference parameters bind the caller's lvalue, never a temporary
+struct DerivedCounter : CopyCounter
+{
+};
+
+static_assert(!sig::bindsArgument<int &, int>);
+static_assert(!sig::bindsArgument<int &, long &>);
+static_assert(!sig::bindsArgument<int &, const int &>);
+static_assert(sig::bindsArgument<int &, int &>);
+static_assert(sig::bindsArgument<CopyCounter &, DerivedCounter &>);
+static_assert(sig::bindsArgument<const int &, long>);
+
+TEST(argumentCopy, NonConstReferenceSlots)
+{
+    sig::Signal<void(CopyCounter &)> signal;
+    CopyCounter *seen = nullptr;
+    signal.connectSlot([&seen](CopyCounter &counter) { seen = &counter; });
+    DerivedCounter derived;
+    CopyCounter::reset();
+    signal.emitSignal(derived);
+    EXPECT_EQ(seen, &derived);
+    EXPECT_EQ(CopyCounter::copies, 0);
+}
+
 /**
  * Project statement test
  */
@@ -533,6 +950,26 @@ TEST(vectorCombiner, SameTwoTime)
     EXPECT_EQ(res, expect);
 }
 
+// Copies keep the collected results, fresh() and emissions start empty
+TEST(vectorCombiner, CopyAndFresh)
+{
+    sig::VectorCombiner<int> combiner;
+    combiner.combine(1);
+    combiner.combine(2);
+    sig::VectorCombiner<int> copy(combiner);
+    sig::VectorCombiner<int> assigned;
+    assigned.combine(3);
+    assigned = combiner;
+    EXPECT_EQ(copy.result(), (std::vector<int>{1, 2}));
+    EXPECT_EQ(assigned.result(), (std::vector<int>{1, 2}));
+    EXPECT_TRUE(combiner.fresh().result().empty());
+
+    sig::Signal<int(), sig::VectorCombiner<int>> signal(combiner);
+    signal.connectSlot(&callback_3);
+    EXPECT_EQ(signal.emitSignal(), (std::vector<int>{1}));
+    EXPECT_EQ(signal.clone().emitSignal(), (std::vector<int>{1}));
+}
+
 // VectorCombiner with void type
 TEST(vectorCombiner, returnTypeVoid)
 {
@@ -551,93 +988,492 @@ TEST(vectorCombiner, returnTypeVoid)
 }
 
 /**
- * No-copy tests
+ * Per-emission combiner tests
  */
 
-TEST(noCopy, OutputTypeVectorCombiner)
+// A combiner recording the reserve hint it receives
+class ReserveCombiner
 {
-    sig::Signal<std::unique_ptr<int>(), sig::VectorCombiner<std::unique_ptr<int>>> signal;
-    signal.connectSlot(&callback_10);
-    signal.connectSlot(&callback_11);
+public:
+    using result_type = std::size_t;
 
-    std::vector<std::unique_ptr<int>> expect;
-    expect.push_back(std::make_unique<int>(10));
-    expect.push_back(std::make_unique<int>(11));
-    std::vector<std::unique_ptr<int>> res = signal.emitSignal();
+    template <typename U>
+    void combine(U &&)
+    {
+    }
 
-    EXPECT_EQ(*res[0].get(), *expect[0].get());
-    EXPECT_EQ(*res[1].get(), *expect[1].get());
-}
+    void reserve(std::size_t count)
+    {
+        m_reserved = count;
+    }
 
-TEST(noCopy, InputTypeVectorCombiner)
-{
-    sig::Signal<int(NoCopy), sig::VectorCombiner<int>> signal;
-    signal.connectSlot(&callback_12);
-    signal.connectSlot(&callback_13);
+    result_type result()
+    {
+        return m_reserved;
+    }
 
-    NoCopy nc(4);
-    std::vector<int> res = signal.emitSignal(std::move(nc));
-    std::vector<int> expect = {20, 24};
+private:
+    std::size_t m_reserved = 0;
+};
 
-    EXPECT_EQ(res, expect);
+// The last result of a previous emission does not leak
+TEST(perEmissionCombiner, NoStaleLastResult)
+{
+    sig::Signal<int(), sig::LastCombiner<int>> signal;
+    std::size_t id = signal.connectSlot(&callback_5);
+    EXPECT_EQ(signal.emitSignal(), 3);
+    signal.disconnectSlot(id);
+    EXPECT_EQ(signal.emitSignal(), 0);
 }
 
-TEST(noCopy, OutputTypeVoidVectorCombiner)
+// Every emission returns only its own results
+TEST(perEmissionCombiner, FreshVector)
 {
-    sig::Signal<void(NoCopy), sig::VectorCombiner<void>> signal;
-    std::vector<NoCopy> res;
-    signal.connectSlot([&res](NoCopy nc){ nc.int_no_copy = nc.int_no_copy + 1;
-                                          res.push_back(std::move(nc)); });
-    signal.connectSlot([&res](NoCopy nc){ nc.int_no_copy = nc.int_no_copy * 2;
-                                          res.push_back(std::move(nc)); });
-    signal.emitSignal(2);
-    EXPECT_EQ(res.size(), 2u);
-    EXPECT_EQ(res[0].int_no_copy, 3);
-    EXPECT_EQ(res[1].int_no_copy, 4);
+    sig::Signal<int(), sig::VectorCombiner<int>> signal;
+    signal.connectSlot(&callback_3);
+    signal.connectSlot(&callback_4);
+    std::vector<int> expect = {1, 2};
+    EXPECT_EQ(signal.emitSignal(), expect);
+    EXPECT_EQ(signal.emitSignal(), expect);
 }
 
-TEST(noCopy, OutputTypeLastCombiner)
+// An emission from inside a slot has its own combiner
+TEST(perEmissionCombiner, NestedEmission)
 {
-    sig::Signal<std::unique_ptr<int>(), sig::LastCombiner<std::unique_ptr<int>>> signal;
-    signal.connectSlot(&callback_10);
-    signal.connectSlot(&callback_11);
-
-    std::vector<std::unique_ptr<int>> expect;
-    expect.push_back(std::make_unique<int>(10));
-    expect.push_back(std::make_unique<int>(11));
-    std::unique_ptr<int> res = signal.emitSignal();
+    sig::Signal<int(int), sig::VectorCombiner<int>> signal;
+    signal.connectSlot([&signal](int depth)
+    {
+        if (depth == 0)
+        {
+            return 0;
+        }
+        return static_cast<int>(signal.emitSignal(depth - 1).size()) * 10;
+    });
+    signal.connectSlot([](int depth) { return depth; });
 
-    EXPECT_EQ(*res.get(), *expect[1].get());
+    std::vector<int> expect = {20, 1};
+    EXPECT_EQ(signal.emitSignal(1), expect);
 }
 
-TEST(noCopy, InputTypeLastCombiner)
+// Combiners providing reserve() receive the number of slots
+TEST(perEmissionCombiner, ReserveHint)
 {
-    sig::Signal<int(NoCopy), sig::LastCombiner<int>> signal;
-    signal.connectSlot(&callback_12);
-    signal.connectSlot(&callback_13);
-
-    int expect = 30;
-    int res = signal.emitSignal(NoCopy(5));
+    sig::Signal<int(), ReserveCombiner> signal;
+    signal.connectSlot(&callback_3);
+    signal.connectSlot(&callback_4);
+    signal.connectSlot(&callback_5);
+    EXPECT_EQ(signal.emitSignal(), 3u);
 
-    EXPECT_EQ(res, expect);
+    sig::StaticSignal<int(), ReserveCombiner, &callback_3, &callback_4> staticSignal;
+    EXPECT_EQ(staticSignal.emitSignal(), 2u);
 }
 
-TEST(noCopy, OutputTypeVoidLastCombiner)
+/**
+ * Short-circuiting combiner tests
+ */
+
+// Slots after the first one are not invoked
+TEST(shortCircuit, First)
 {
-    sig::Signal<void(NoCopy), sig::LastCombiner<void>> signal;
-    NoCopy res;
-    signal.connectSlot([&res](NoCopy nc){ nc.int_no_copy = nc.int_no_copy + 1;
-                                          res = std::move(nc); });
-    signal.connectSlot([&res](NoCopy nc){ nc.int_no_copy = nc.int_no_copy * 2;
-                                          res = std::move(nc); });
-    signal.emitSignal(NoCopy(4));
-    EXPECT_EQ(res.int_no_copy, 8);
+    sig::Signal<int(), sig::FirstCombiner<int>> signal;
+    int calls = 0;
+    signal.connectSlot([&calls]() { ++calls; return 1; });
+    signal.connectSlot([&calls]() { ++calls; return 2; });
+    signal.connectSlot([&calls]() { ++calls; return 3; });
+    EXPECT_EQ(signal.emitSignal(), 1);
+    EXPECT_EQ(calls, 1);
 }
 
-TEST(noCopy, OutputTypeDiscardCombiner)
+TEST(shortCircuit, FirstNoSlot)
 {
-    sig::Signal<void(NoCopy &)> signal;
-    std::vector<int> int_vector;
+    sig::Signal<int(), sig::FirstCombiner<int>> signal;
+    EXPECT_EQ(signal.emitSignal(), 0);
+}
+
+TEST(shortCircuit, AnyOf)
+{
+    sig::Signal<bool(int), sig::AnyOfCombiner> signal;
+    int calls = 0;
+    signal.connectSlot([&calls](int x) { ++calls; return x == 1; });
+    signal.connectSlot([&calls](int x) { ++calls; return x == 2; });
+    signal.connectSlot([&calls](int x) { ++calls; return x == 3; });
+    EXPECT_TRUE(signal.emitSignal(2));
+    EXPECT_EQ(calls, 2);
+    EXPECT_FALSE(signal.emitSignal(4));
+    EXPECT_EQ(calls, 5);
+}
+
+TEST(shortCircuit, AllOf)
+{
+    sig::Signal<bool(int), sig::AllOfCombiner> signal;
+    int calls = 0;
+    signal.connectSlot([&calls](int x) { ++calls; return x > 0; });
+    signal.connectSlot([&calls](int x) { ++calls; return x > 10; });
+    signal.connectSlot([&calls](int x) { ++calls; return x > 100; });
+    EXPECT_FALSE(signal.emitSignal(5));
+    EXPECT_EQ(calls, 2);
+    EXPECT_TRUE(signal.emitSignal(500));
+    EXPECT_EQ(calls, 5);
+
+    sig::Signal<bool(int), sig::AllOfCombiner> empty;
+    EXPECT_TRUE(empty.emitSignal(0));
+}
+
+struct IsEven
+{
+    bool operator()(int x) const
+    {
+        return x % 2 == 0;
+    }
+};
+
+TEST(shortCircuit, FirstMatching)
+{
+    sig::Signal<int(), sig::FirstMatchingCombiner<int, IsEven>> signal;
+    int calls = 0;
+    signal.connectSlot([&calls]() { ++calls; return 1; });
+    signal.connectSlot([&calls]() { ++calls; return 4; });
+    signal.connectSlot([&calls]() { ++calls; return 6; });
+    std::optional<int> res = signal.emitSignal();
+    ASSERT_TRUE(res.has_value());
+    EXPECT_EQ(*res, 4);
+    EXPECT_EQ(calls, 2);
+
+    sig::Signal<int(), sig::FirstMatchingCombiner<int, IsEven>> noMatch;
+    noMatch.connectSlot(&callback_3);
+    EXPECT_FALSE(noMatch.emitSignal().has_value());
+}
+
+TEST(shortCircuit, StaticSignal)
+{
+    sig::StaticSignal<int(), sig::FirstCombiner<int>, &callback_4, &callback_5> signal;
+    EXPECT_EQ(signal.emitSignal(), 2);
+}
+
+/**
+ * Range combiner tests
+ */
+
+// Sums every result through the iterator range
+class SumRangeCombiner
+{
+public:
+    using result_type = int;
+
+    template <typename InputIt>
+    result_type operator()(InputIt first, InputIt last)
+    {
+        return std::accumulate(first, last, 0);
+    }
+};
+
+// Pulls results until one is greater than the limit
+class FirstAboveCombiner
+{
+public:
+    using result_type = int;
+
+    FirstAboveCombiner(int limit = 0) : m_limit(limit) {}
+
+    template <typename InputIt>
+    result_type operator()(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            if (*first > m_limit)
+            {
+                return *first;
+            }
+        }
+        return -1;
+    }
+
+private:
+    int m_limit;
+};
+
+// Moves the results out with post-increment
+template <typename T>
+class CollectRangeCombiner
+{
+public:
+    using result_type = std::vector<T>;
+
+    template <typename InputIt>
+    result_type operator()(InputIt first, InputIt last)
+    {
+        result_type results;
+        while (first != last)
+        {
+            results.push_back(std::move(*first++));
+        }
+        return results;
+    }
+};
+
+TEST(rangeCombiner, Sum)
+{
+    sig::Signal<int(), SumRangeCombiner> signal;
+    EXPECT_EQ(signal.emitSignal(), 0);
+    signal.connectSlot(&callback_3);
+    signal.connectSlot(&callback_4);
+    std::size_t id = signal.connectSlot(&callback_5);
+    signal.connectSlot(&callback_5);
+    signal.disconnectSlot(id);
+    EXPECT_EQ(signal.emitSignal(), 6);
+}
+
+// Slots are invoked only when their result is pulled, and once
+TEST(rangeCombiner, Lazy)
+{
+    sig::Signal<int(int), FirstAboveCombiner> signal(FirstAboveCombiner(5));
+    int calls = 0;
+    signal.connectSlot([&calls](int x) { ++calls; return x; });
+    signal.connectSlot([&calls](int x) { ++calls; return x * 2; });
+    signal.connectSlot([&calls](int x) { ++calls; return x * 3; });
+    EXPECT_EQ(signal.emitSignal(3), 6);
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(signal.emitSignal(1), -1);
+    EXPECT_EQ(calls, 5);
+}
+
+TEST(rangeCombiner, MoveOnlyResults)
+{
+    sig::Signal<std::unique_ptr<int>(), CollectRangeCombiner<std::unique_ptr<int>>> signal;
+    signal.connectSlot(&callback_10);
+    signal.connectSlot(&callback_11);
+    auto res = signal.emitSignal();
+    ASSERT_EQ(res.size(), 2u);
+    EXPECT_EQ(*res[0], 10);
+    EXPECT_EQ(*res[1], 11);
+}
+
+// The last slot still receives the moved argument
+TEST(rangeCombiner, MovesToLastSlot)
+{
+    sig::Signal<int(CopyCounter), SumRangeCombiner> signal;
+    signal.connectSlot([](CopyCounter) { return 1; });
+    signal.connectSlot([](CopyCounter) { return 2; });
+    CopyCounter::reset();
+    EXPECT_EQ(signal.emitSignal(CopyCounter()), 3);
+    EXPECT_EQ(CopyCounter::copies, 1);
+    EXPECT_EQ(CopyCounter::moves, 1);
+}
+
+// Collects the addresses of results returned by reference
+class AddressRangeCombiner
+{
+public:
+    using result_type = std::vector<int *>;
+
+    template <typename InputIt>
+    result_type operator()(InputIt first, InputIt last)
+    {
+        result_type results;
+        if (first != last)
+        {
+            results.push_back(&*first++);
+        }
+        for (; first != last; ++first)
+        {
+            results.push_back(&*first);
+        }
+        return results;
+    }
+};
+
+// Slots may return references, with plain and range combiners alike
+TEST(rangeCombiner, ReferenceResults)
+{
+    int first = 1;
+    int second = 2;
+    sig::Signal<int &(), sig::LastCombiner<int>> last;
+    last.connectSlot([&first]() -> int & { return first; });
+    last.connectSlot([&second]() -> int & { return second; });
+    EXPECT_EQ(last.emitSignal(), 2);
+
+    sig::Signal<int &(), AddressRangeCombiner> range;
+    range.connectSlot([&first]() -> int & { return first; });
+    range.connectSlot([&second]() -> int & { return second; });
+    range.connectSlot([&second]() -> int & { return second; });
+    EXPECT_EQ(range.emitSignal(), (std::vector<int *>{&first, &second, &second}));
+
+    sig::Signal<const int &(), SumRangeCombiner> sum;
+    sum.connectSlot([&first]() -> const int & { return first; });
+    sum.connectSlot([&second]() -> const int & { return second; });
+    EXPECT_EQ(sum.emitSignal(), 3);
+}
+
+/**
+ * Caller-supplied result buffer tests
+ */
+
+// Results are written through an output iterator
+TEST(emitInto, OutputIterator)
+{
+    sig::Signal<int(int), sig::LastCombiner<int>> signal;
+    signal.connectSlot(&callback_15);
+    signal.connectSlot([](int x) { return x + 1; });
+
+    int results[3] = {0, 0, 0};
+    int *end = signal.emitInto(results, 4);
+    EXPECT_EQ(end, results + 2);
+    EXPECT_EQ(results[0], 8);
+    EXPECT_EQ(results[1], 5);
+    EXPECT_EQ(results[2], 0);
+}
+
+// A reused vector makes steady-state emission allocation free
+TEST(emitInto, ReusedVector)
+{
+    sig::Signal<int(), sig::VectorCombiner<int>> signal;
+    signal.connectSlot(&callback_3);
+    signal.connectSlot(&callback_4);
+    signal.connectSlot(&callback_5);
+
+    std::vector<int> results = {7, 7, 7, 7, 7};
+    signal.emitInto(results);
+    std::vector<int> expect = {1, 2, 3};
+    EXPECT_EQ(results, expect);
+
+    std::size_t before = allocationCount;
+    signal.emitInto(results);
+    EXPECT_EQ(allocationCount, before);
+    EXPECT_EQ(results, expect);
+}
+
+// Move-only results are moved into the buffer
+TEST(emitInto, MoveOnlyResults)
+{
+    sig::Signal<std::unique_ptr<int>()> signal;
+    signal.connectSlot(&callback_10);
+    signal.connectSlot(&callback_11);
+
+    std::vector<std::unique_ptr<int>> results;
+    signal.emitInto(results);
+    EXPECT_EQ(results.size(), 2u);
+    EXPECT_EQ(*results[0], 10);
+    EXPECT_EQ(*results[1], 11);
+}
+
+// OutputCombiner writes through the iterator it was built with
+TEST(emitInto, OutputCombiner)
+{
+    std::vector<int> results;
+    using Combiner = sig::OutputCombiner<std::back_insert_iterator<std::vector<int>>>;
+    sig::Signal<int(), Combiner> signal(Combiner(std::back_inserter(results)));
+    signal.connectSlot(&callback_3);
+    signal.connectSlot(&callback_4);
+    signal.emitSignal();
+    signal.emitSignal();
+    std::vector<int> expect = {1, 2, 1, 2};
+    EXPECT_EQ(results, expect);
+}
+
+/**
+ * No-copy tests
+ */
+
+TEST(noCopy, OutputTypeVectorCombiner)
+{
+    sig::Signal<std::unique_ptr<int>(), sig::VectorCombiner<std::unique_ptr<int>>> signal;
+    signal.connectSlot(&callback_10);
+    signal.connectSlot(&callback_11);
+
+    std::vector<std::unique_ptr<int>> expect;
+    expect.push_back(std::make_unique<int>(10));
+    expect.push_back(std::make_unique<int>(11));
+    std::vector<std::unique_ptr<int>> res = signal.emitSignal();
+
+    EXPECT_EQ(*res[0].get(), *expect[0].get());
+    EXPECT_EQ(*res[1].get(), *expect[1].get());
+}
+
+TEST(noCopy, InputTypeVectorCombiner)
+{
+    sig::Signal<int(NoCopy), sig::VectorCombiner<int>> signal;
+    signal.connectSlot(&callback_12);
+    signal.connectSlot(&callback_13);
+
+    NoCopy nc(4);
+    std::vector<int> res = signal.emitSignal(std::move(nc));
+    std::vector<int> expect = {20, 24};
+
+    EXPECT_EQ(res, expect);
+}
+
+TEST(noCopy, OutputTypeVoidVectorCombiner)
+{
+    sig::Signal<void(NoCopy), sig::VectorCombiner<void>> signal;
+    std::vector<NoCopy> res;
+    signal.connectSlot([&res](const NoCopy &nc){ res.emplace_back(nc.int_no_copy + 1); });
+    signal.connectSlot([&res](const NoCopy &nc){ res.emplace_back(nc.int_no_copy * 2); });
+    signal.emitSignal(2);
+    EXPECT_EQ(res.size(), 2u);
+    EXPECT_EQ(res[0].int_no_copy, 3);
+    EXPECT_EQ(res[1].int_no_copy, 4);
+}
+
+TEST(noCopy, OutputTypeLastCombiner)
+{
+    sig::Signal<std::unique_ptr<int>(), sig::LastCombiner<std::unique_ptr<int>>> signal;
+    signal.connectSlot(&callback_10);
+    signal.connectSlot(&callback_11);
+
+    std::vector<std::unique_ptr<int>> expect;
+    expect.push_back(std::make_unique<int>(10));
+    expect.push_back(std::make_unique<int>(11));
+    std::unique_ptr<int> res = signal.emitSignal();
+
+    EXPECT_EQ(*res.get(), *expect[1].get());
+}
+
+TEST(noCopy, InputTypeLastCombiner)
+{
+    sig::Signal<int(NoCopy), sig::LastCombiner<int>> signal;
+    signal.connectSlot(&callback_12);
+    signal.connectSlot(&callback_13);
+
+    int expect = 30;
+    int res = signal.emitSignal(NoCopy(5));
+
+    EXPECT_EQ(res, expect);
+}
+
+TEST(noCopy, OutputTypeVoidLastCombiner)
+{
+    sig::Signal<void(NoCopy), sig::LastCombiner<void>> signal;
+    NoCopy res;
+    signal.connectSlot([&res](const NoCopy &nc){ res = NoCopy(nc.int_no_copy + 1); });
+    signal.connectSlot([&res](const NoCopy &nc){ res = NoCopy(nc.int_no_copy * 2); });
+    signal.emitSignal(NoCopy(4));
+    EXPECT_EQ(res.int_no_copy, 8);
+}
+
+// Every slot sees an argument that cannot be copied: none of them may own it
+static_assert(!sig::takesUniqueArguments<void, void (*)(std::unique_ptr<int>), std::unique_ptr<int>>);
+static_assert(!sig::takesUniqueArguments<void, void (*)(std::unique_ptr<int> &&), std::unique_ptr<int>>);
+static_assert(sig::takesUniqueArguments<void, void (*)(const std::unique_ptr<int> &), std::unique_ptr<int>>);
+static_assert(sig::takesUniqueArguments<void, void (*)(std::string), std::string>);
+
+TEST(noCopy, SharedByEverySlot)
+{
+    sig::Signal<int(std::unique_ptr<int>), sig::VectorCombiner<int>> signal;
+    for (int i = 1; i <= 3; ++i)
+    {
+        signal.connectSlot([i](const std::unique_ptr<int> &p) { return p ? *p * i : -1; });
+    }
+    EXPECT_EQ(signal.emitSignal(std::make_unique<int>(2)), (std::vector<int>{2, 4, 6}));
+
+    std::unique_ptr<int> kept = std::make_unique<int>(5);
+    EXPECT_EQ(signal.emitSignal(kept), (std::vector<int>{5, 10, 15}));
+    ASSERT_TRUE(kept);
+}
+
+TEST(noCopy, OutputTypeDiscardCombiner)
+{
+    sig::Signal<void(NoCopy &)> signal;
+    std::vector<int> int_vector;
 
     signal.connectSlot([&int_vector](NoCopy &nc){ int_vector.push_back(nc.int_no_copy + 1); });
     signal.connectSlot([&int_vector](NoCopy &nc){ int_vector.push_back(nc.int_no_copy + 2); });
@@ -650,6 +1486,58 @@ TEST(noCopy, OutputTypeDiscardCombiner)
     EXPECT_EQ(int_vector[1], 5);
 }
 
+/**
+ * StaticSignal tests
+*/
+
+struct Doubler
+{
+    int operator()(int x) const
+    {
+        return x * 2;
+    }
+};
+
+static const Doubler doubler;
+
+// Slots run in declaration order
+TEST(staticSignal, DiscardCombiner)
+{
+    sig::StaticSignal<void(int &), sig::DiscardCombiner, &callback_1, &callback_2, &callback_2> signal;
+    int res = 0;
+    signal.emitSignal(res);
+    EXPECT_EQ(res, 3);
+    static_assert(decltype(signal)::slotCount() == 3);
+}
+
+TEST(staticSignal, LastCombiner)
+{
+    sig::StaticSignal<int(), sig::LastCombiner<int>, &callback_3, &callback_4, &callback_6> signal;
+    EXPECT_EQ(signal.emitSignal(), 97);
+}
+
+// Function pointers and static callable objects can be mixed
+TEST(staticSignal, VectorCombiner)
+{
+    sig::StaticSignal<int(int), sig::VectorCombiner<int>, &callback_15, &doubler> signal;
+    std::vector<int> expect = {6, 6};
+    EXPECT_EQ(signal.emitSignal(3), expect);
+}
+
+TEST(staticSignal, NoSlot)
+{
+    sig::StaticSignal<int(), sig::VectorCombiner<int>> signal;
+    EXPECT_TRUE(signal.emitSignal().empty());
+}
+
+TEST(staticSignal, NoCopy)
+{
+    sig::StaticSignal<std::unique_ptr<int>(), sig::VectorCombiner<std::unique_ptr<int>>, &callback_10, &callback_11> signal;
+    std::vector<std::unique_ptr<int>> res = signal.emitSignal();
+    EXPECT_EQ(*res[0], 10);
+    EXPECT_EQ(*res[1], 11);
+}
+
 /**
  * Multiple signals tests
 */
@@ -665,6 +1553,1890 @@ TEST(multipleSignals, Default)
     EXPECT_EQ(res2, 98);
 }
 
+/**
+ * ConcurrentSignal tests
+*/
+
+TEST(concurrentSignal, ConnectEmitDisconnect)
+{
+    sig::ConcurrentSignal<int(int), sig::VectorCombiner<int>> signal;
+    Receiver receiver;
+    receiver.setValue(1);
+    std::size_t id1 = signal.connectSlot(&callback_15);
+    signal.connectSlot<&Receiver::add>(&receiver);
+    signal.connectSlot([](int x) { return -x; });
+    std::vector<int> expect = {6, 4, -3};
+    EXPECT_EQ(signal.emitSignal(3), expect);
+
+    signal.disconnectSlot(id1);
+    signal.disconnectSlot(id1);
+    expect = {4, -3};
+    EXPECT_EQ(signal.emitSignal(3), expect);
+    EXPECT_EQ(signal.slotCount(), 2u);
+}
+
+TEST(concurrentSignal, ShortCircuitAndMove)
+{
+    sig::ConcurrentSignal<int(CopyCounter), sig::FirstCombiner<int>> signal;
+    signal.connectSlot([](CopyCounter) { return 1; });
+    signal.connectSlot([](CopyCounter) { return 2; });
+    CopyCounter::reset();
+    EXPECT_EQ(signal.emitSignal(CopyCounter()), 1);
+    EXPECT_EQ(CopyCounter::copies, 1);
+}
+
+// Emitters keep running while slots are connected and disconnected
+TEST(concurrentSignal, ConcurrentEmitAndConnect)
+{
+    sig::ConcurrentSignal<void(int)> signal;
+    std::atomic<long> permanent{0};
+    std::atomic<long> transient{0};
+    signal.connectSlot([&permanent](int x) { permanent += x; });
+
+    constexpr int threadCount = 4;
+    constexpr int emitCount = 2000;
+    std::atomic<bool> start{false};
+    std::vector<std::thread> emitters;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        emitters.emplace_back([&]()
+        {
+            while (!start)
+            {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < emitCount; ++i)
+            {
+                signal.emitSignal(1);
+            }
+        });
+    }
+
+    start = true;
+    for (int i = 0; i < 200; ++i)
+    {
+        std::size_t id = signal.connectSlot([&transient](int x) { transient += x; });
+        std::this_thread::yield();
+        signal.disconnectSlot(id);
+    }
+    for (auto &emitter : emitters)
+    {
+        emitter.join();
+    }
+
+    EXPECT_EQ(permanent, threadCount * emitCount);
+    EXPECT_EQ(signal.slotCount(), 1u);
+}
+
+// A slot disconnected by another thread finishes its running invocation
+TEST(concurrentSignal, DisconnectWhileRunning)
+{
+    sig::ConcurrentSignal<int(), sig::LastCombiner<int>> signal;
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    std::size_t id = signal.connectSlot([&, value = std::make_unique<int>(7)]()
+    {
+        entered = true;
+        while (!release)
+        {
+            std::this_thread::yield();
+        }
+        return *value;
+    });
+
+    int res = 0;
+    std::thread emitter([&]() { res = signal.emitSignal(); });
+    while (!entered)
+    {
+        std::this_thread::yield();
+    }
+    signal.disconnectSlot(id);
+    release = true;
+    emitter.join();
+
+    EXPECT_EQ(res, 7);
+    EXPECT_EQ(signal.emitSignal(), 0);
+}
+
+// A disconnected slot is destroyed once the emission using it has left
+TEST(concurrentSignal, ReclaimAfterEmission)
+{
+    struct Flag
+    {
+        explicit Flag(std::atomic<bool> *destroyed) : destroyed(destroyed) {}
+        ~Flag() { *destroyed = true; }
+        std::atomic<bool> *destroyed;
+    };
+
+    sig::ConcurrentSignal<void()> signal;
+    std::atomic<bool> destroyed{false};
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    auto flag = std::make_shared<Flag>(&destroyed);
+    std::size_t id = signal.connectSlot([&, flag = std::move(flag)]()
+    {
+        entered = true;
+        while (!release)
+        {
+            std::this_thread::yield();
+        }
+    });
+
+    std::thread emitter([&]() { signal.emitSignal(); });
+    while (!entered)
+    {
+        std::this_thread::yield();
+    }
+    signal.disconnectSlot(id);
+    sig::EpochDomain::instance().collect();
+    EXPECT_FALSE(destroyed);
+
+    release = true;
+    emitter.join();
+    sig::EpochDomain::instance().collect();
+    EXPECT_TRUE(destroyed);
+}
+
+// A slot destructor can disconnect and connect slots of the same signal
+TEST(concurrentSignal, SlotDestructorRewires)
+{
+    using Signal = sig::ConcurrentSignal<int(), sig::VectorCombiner<int>>;
+    struct Rewire
+    {
+        Rewire(Signal *signal, std::size_t id) : signal(signal), id(id) {}
+        ~Rewire()
+        {
+            signal->disconnectSlot(id);
+            signal->connectSlot([]() { return 3; });
+        }
+        Signal *signal;
+        std::size_t id;
+    };
+
+    Signal signal;
+    std::size_t first = signal.connectSlot([]() { return 1; });
+    auto rewire = std::make_shared<Rewire>(&signal, first);
+    std::size_t second = signal.connectSlot([rewire = std::move(rewire)]() { return 2; });
+    EXPECT_EQ(signal.emitSignal(), (std::vector<int>{1, 2}));
+
+    signal.disconnectSlot(second);
+    sig::EpochDomain::instance().collect();
+    EXPECT_EQ(signal.emitSignal(), (std::vector<int>{3}));
+}
+
+// Emitting neither allocates nor takes a reference
+TEST(concurrentSignal, EmitNoAllocation)
+{
+    sig::ConcurrentSignal<void(int)> signal;
+    int res = 0;
+    signal.connectSlot([&res](int x) { res += x; });
+    signal.emitSignal(1);
+    std::size_t before = allocationCount;
+    signal.emitSignal(2);
+    EXPECT_EQ(allocationCount, before);
+    EXPECT_EQ(res, 3);
+}
+
+// Emissions can nest across concurrent signals
+TEST(concurrentSignal, NestedEmission)
+{
+    sig::ConcurrentSignal<int(int), sig::LastCombiner<int>> inner;
+    sig::ConcurrentSignal<int(int), sig::LastCombiner<int>> outer;
+    inner.connectSlot([](int x) { return x * 2; });
+    outer.connectSlot([&inner](int x) { return inner.emitSignal(x) + 1; });
+    EXPECT_EQ(outer.emitSignal(4), 9);
+}
+
+/**
+ * LockFreeSignal tests
+*/
+
+// Connect, emit in connection order and disconnect
+TEST(lockFreeSignal, ConnectEmitDisconnect)
+{
+    sig::LockFreeSignal<int(int), sig::VectorCombiner<int>> signal;
+    std::size_t first = signal.connectSlot([](int x) { return x; });
+    signal.connectSlot<&callback_15>();
+    signal.connectSlot([](int x) { return x * 3; });
+    EXPECT_EQ(signal.slotCount(), 3u);
+    EXPECT_EQ(signal.emitSignal(2), (std::vector<int>{2, 4, 6}));
+
+    signal.disconnectSlot(first);
+    signal.disconnectSlot(first);
+    EXPECT_EQ(signal.slotCount(), 2u);
+    EXPECT_EQ(signal.emitSignal(2), (std::vector<int>{4, 6}));
+}
+
+// The combiner can stop the emission, and slots share arguments that cannot be copied
+TEST(lockFreeSignal, ShortCircuitAndMove)
+{
+    sig::LockFreeSignal<int(std::unique_ptr<int>), sig::FirstCombiner<int>> signal;
+    signal.connectSlot([](const std::unique_ptr<int> &p) { return *p; });
+    EXPECT_EQ(signal.emitSignal(std::make_unique<int>(4)), 4);
+
+    sig::LockFreeSignal<int(int), sig::FirstMatchingCombiner<int, IsEven>> matching;
+    int calls = 0;
+    matching.connectSlot([&calls](int x) { ++calls; return x; });
+    matching.connectSlot([&calls](int x) { ++calls; return x * 2; });
+    matching.connectSlot([&calls](int x) { ++calls; return x * 4; });
+    EXPECT_EQ(matching.emitSignal(1), 2);
+    EXPECT_EQ(calls, 2);
+}
+
+// Emitters keep running while other threads connect and disconnect
+TEST(lockFreeSignal, ConcurrentEmitAndChurn)
+{
+    sig::LockFreeSignal<void(int)> signal;
+    std::atomic<long> permanent{0};
+    std::atomic<long> transient{0};
+    signal.connectSlot([&permanent](int x) { permanent += x; });
+
+    constexpr int threadCount = 4;
+    constexpr int emitCount = 2000;
+    std::atomic<bool> start{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&]()
+        {
+            while (!start)
+            {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < emitCount; ++i)
+            {
+                signal.emitSignal(1);
+            }
+        });
+        threads.emplace_back([&]()
+        {
+            while (!start)
+            {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < 200; ++i)
+            {
+                std::size_t id = signal.connectSlot([&transient](int x) { transient += x; });
+                std::this_thread::yield();
+                signal.disconnectSlot(id);
+            }
+        });
+    }
+
+    start = true;
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(permanent, threadCount * emitCount);
+    EXPECT_EQ(signal.slotCount(), 1u);
+}
+
+// A disconnected slot is destroyed once no emission protects it anymore
+TEST(lockFreeSignal, ReclaimAfterEmission)
+{
+    struct Flag
+    {
+        explicit Flag(std::atomic<bool> *destroyed) : destroyed(destroyed) {}
+        ~Flag() { *destroyed = true; }
+        std::atomic<bool> *destroyed;
+    };
+
+    sig::LockFreeSignal<void()> signal;
+    std::atomic<bool> destroyed{false};
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    auto flag = std::make_shared<Flag>(&destroyed);
+    std::size_t id = signal.connectSlot([&, flag = std::move(flag)]()
+    {
+        entered = true;
+        while (!release)
+        {
+            std::this_thread::yield();
+        }
+    });
+
+    std::thread emitter([&]() { signal.emitSignal(); });
+    while (!entered)
+    {
+        std::this_thread::yield();
+    }
+    signal.disconnectSlot(id);
+    sig::HazardDomain::instance().collect();
+    EXPECT_FALSE(destroyed);
+
+    release = true;
+    emitter.join();
+    sig::HazardDomain::instance().collect();
+    EXPECT_TRUE(destroyed);
+}
+
+// Slots run in connection order, with the last ones appended and disconnected concurrently
+TEST(lockFreeSignal, AppendInOrder)
+{
+    sig::LockFreeSignal<int(), sig::VectorCombiner<int>> signal;
+    std::size_t last = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        last = signal.connectSlot([i]() { return i; });
+    }
+    signal.disconnectSlot(last);
+    signal.connectSlot([]() { return 5; });
+    EXPECT_EQ(signal.emitSignal(), (std::vector<int>{0, 1, 2, 3, 5}));
+
+    constexpr int threadCount = 4;
+    constexpr int connectCount = 500;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&signal, t]()
+        {
+            for (int i = 0; i < connectCount; ++i)
+            {
+                std::size_t id = signal.connectSlot([value = (t + 1) * 1000 + i]() { return value; });
+                if (i % 2)
+                {
+                    signal.disconnectSlot(id);
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    std::vector<int> values = signal.emitSignal();
+    EXPECT_EQ(values.size(), 5u + threadCount * connectCount / 2);
+    std::vector<int> previous(threadCount + 1, -1);
+    for (int value : values)
+    {
+        int &seen = previous[value / 1000];
+        EXPECT_LT(seen, value);
+        seen = value;
+    }
+}
+
+// Emissions can nest, each level protecting its own nodes
+TEST(lockFreeSignal, NestedEmission)
+{
+    sig::LockFreeSignal<int(int), sig::LastCombiner<int>> signal;
+    signal.connectSlot([](int x) { return x + 1; });
+    signal.connectSlot([&signal](int x) { return x > 8 ? x : signal.emitSignal(x * 2); });
+    EXPECT_EQ(signal.emitSignal(1), 16);
+}
+
+/**
+ * Queued connection tests
+*/
+
+// The ring keeps FIFO order, refuses pushes when full and wraps around
+TEST(mpscRing, FifoFullAndWrap)
+{
+    sig::MpscRing<int> ring(3);
+    EXPECT_EQ(ring.capacity(), 4u);
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_TRUE(ring.tryPush(round * 10 + i));
+        }
+        EXPECT_FALSE(ring.tryPush(99));
+
+        std::vector<int> values;
+        while (ring.consume([&values](int &value) { values.push_back(value); }))
+        {
+        }
+        EXPECT_EQ(values, (std::vector<int>{round * 10, round * 10 + 1, round * 10 + 2, round * 10 + 3}));
+    }
+}
+
+// Elements left in the ring are destroyed with it
+TEST(mpscRing, DestroysPending)
+{
+    auto value = std::make_shared<int>(1);
+    {
+        sig::MpscRing<std::shared_ptr<int>> ring(4);
+        ring.tryPush(value);
+        ring.tryPush(value);
+        EXPECT_EQ(value.use_count(), 3);
+    }
+    EXPECT_EQ(value.use_count(), 1);
+}
+
+// A queued slot runs when the loop drains, with copies of the arguments
+TEST(queuedConnection, RunsOnDrain)
+{
+    sig::EventLoop loop;
+    sig::Signal<void(const std::string &, int)> signal;
+    std::vector<std::string> received;
+    signal.connectSlot(loop, [&received](const std::string &text, int count)
+    {
+        received.push_back(text + std::to_string(count));
+    });
+
+    {
+        std::string text = "a";
+        signal.emitSignal(text, 1);
+        text = "b";
+        signal.emitSignal(text, 2);
+    }
+    EXPECT_TRUE(received.empty());
+    EXPECT_EQ(loop.drain(), 2u);
+    EXPECT_EQ(received, (std::vector<std::string>{"a1", "b2"}));
+    EXPECT_EQ(loop.drain(), 0u);
+}
+
+// Pending deliveries survive a disconnect, and drain runs batches
+TEST(queuedConnection, DisconnectAndBatches)
+{
+    sig::EventLoop loop;
+    sig::Signal<void(int)> signal;
+    int sum = 0;
+    std::size_t id = signal.connectSlot(loop, [&sum](int x) { sum += x; });
+    for (int i = 1; i <= 4; ++i)
+    {
+        signal.emitSignal(i);
+    }
+    signal.disconnectSlot(id);
+    signal.emitSignal(100);
+
+    EXPECT_EQ(loop.drain(3), 3u);
+    EXPECT_EQ(sum, 6);
+    EXPECT_EQ(loop.drain(), 1u);
+    EXPECT_EQ(sum, 10);
+}
+
+// Direct and queued slots mix, and the queue applies back-pressure
+TEST(queuedConnection, MixedAndFull)
+{
+    sig::EventLoop loop(2);
+    sig::Signal<void(int)> signal;
+    int direct = 0;
+    int queued = 0;
+    signal.connectSlot([&direct](int x) { direct += x; });
+    signal.connectSlot(loop, [&queued](int x) { queued += x; });
+    signal.emitSignal(1);
+    signal.emitSignal(2);
+    EXPECT_EQ(direct, 3);
+    EXPECT_FALSE(loop.tryPost([]() {}));
+    loop.drain();
+    EXPECT_EQ(queued, 3);
+}
+
+// Queued slots emitting to their own full loop overflow instead of waiting
+TEST(queuedConnection, ConsumerPostsToFullQueue)
+{
+    sig::EventLoop loop(2);
+    sig::Signal<void(int)> signal;
+    std::vector<int> order;
+    signal.connectSlot(loop, [&](int x)
+                       {
+        order.push_back(x);
+        if (x < 3)
+        {
+            signal.emitSignal(10 * x + 1);
+            signal.emitSignal(10 * x + 2);
+            signal.emitSignal(10 * x + 3);
+        } });
+    signal.emitSignal(1);
+    signal.emitSignal(2);
+    EXPECT_EQ(loop.drain(), 8u);
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 11, 12, 13, 21, 22, 23}));
+}
+
+// Many threads emit into one consumer thread
+TEST(queuedConnection, ManyProducers)
+{
+    sig::EventLoop loop(64);
+    sig::ConcurrentSignal<void(int)> signal;
+    long sum = 0;
+    signal.connectSlot(loop, [&sum](int x) { sum += x; });
+
+    constexpr int producerCount = 4;
+    constexpr int emitCount = 5000;
+    std::atomic<bool> done{false};
+    std::thread consumer([&]()
+    {
+        while (!done)
+        {
+            loop.drain();
+        }
+        loop.drain();
+    });
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < producerCount; ++t)
+    {
+        producers.emplace_back([&]()
+        {
+            for (int i = 0; i < emitCount; ++i)
+            {
+                signal.emitSignal(1);
+            }
+        });
+    }
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+    done = true;
+    consumer.join();
+
+    EXPECT_EQ(sum, producerCount * emitCount);
+}
+
+/**
+ * Parallel emission tests
+*/
+
+// parallelFor visits every index once, also with a single worker
+TEST(threadPool, ParallelForVisitsAll)
+{
+    for (unsigned threads : {1u, 4u})
+    {
+        sig::ThreadPool pool(threads);
+        std::vector<std::atomic<int>> visits(1000);
+        pool.parallelFor(visits.size(), [&visits](std::size_t i) { ++visits[i]; });
+        for (auto &visit : visits)
+        {
+            EXPECT_EQ(visit, 1);
+        }
+    }
+}
+
+// The first exception reaches the caller
+TEST(threadPool, ParallelForThrows)
+{
+    sig::ThreadPool pool(2);
+    EXPECT_THROW(pool.parallelFor(100, [](std::size_t i)
+    {
+        if (i == 42)
+        {
+            throw std::runtime_error("slot failed");
+        }
+    }), std::runtime_error);
+}
+
+// Posted tasks run on the workers, pending ones before the pool is gone
+TEST(threadPool, PostRunsTasks)
+{
+    std::atomic<int> count{0};
+    {
+        sig::ThreadPool pool(2);
+        for (int i = 0; i < 100; ++i)
+        {
+            pool.post([&count]() { ++count; });
+        }
+    }
+    EXPECT_EQ(count, 100);
+}
+
+// A throwing task reaches the error handler and the worker goes on
+TEST(threadPool, PostErrorHandler)
+{
+    std::atomic<int> errors{0};
+    std::atomic<int> count{0};
+    {
+        sig::ThreadPool pool(2, [&errors](std::exception_ptr error)
+        {
+            EXPECT_THROW(std::rethrow_exception(error), std::runtime_error);
+            ++errors;
+        });
+        for (int i = 0; i < 10; ++i)
+        {
+            pool.post([&count, i]()
+            {
+                if (i % 2 == 0)
+                {
+                    throw std::runtime_error("task failed");
+                }
+                ++count;
+            });
+        }
+    }
+    EXPECT_EQ(errors, 5);
+    EXPECT_EQ(count, 5);
+}
+
+// Without a handler the pool keeps the first exception for takeError
+TEST(threadPool, PostTakeError)
+{
+    sig::ThreadPool pool(1);
+    std::atomic<int> count{0};
+    pool.post([]() { throw std::runtime_error("task failed"); });
+    pool.post([]() { throw std::logic_error("ignored"); });
+    pool.post([&count]() { ++count; });
+    while (count == 0)
+    {
+        std::this_thread::yield();
+    }
+    std::exception_ptr error = pool.takeError();
+    ASSERT_TRUE(error);
+    EXPECT_THROW(std::rethrow_exception(error), std::runtime_error);
+    EXPECT_FALSE(pool.takeError());
+}
+
+// Results are combined in connection order
+TEST(parallelEmission, ConnectionOrder)
+{
+    sig::ThreadPool pool(4);
+    sig::Signal<int(int), sig::VectorCombiner<int>> signal;
+    for (int i = 0; i < 40; ++i)
+    {
+        signal.connectSlot([i](int x) { return i * x; });
+    }
+    std::vector<int> expected(40);
+    for (int i = 0; i < 40; ++i)
+    {
+        expected[i] = i * 2;
+    }
+    EXPECT_EQ(signal.emitParallel(pool, 2), expected);
+
+    sig::Signal<int(int), sig::LastCombiner<int>> last;
+    last.connectSlot([](int x) { return x; });
+    last.connectSlot([](int x) { return x + 1; });
+    EXPECT_EQ(last.emitParallel(pool, 5), 6);
+}
+
+// Void slots all run, and an empty signal returns the combiner's default
+TEST(parallelEmission, VoidAndEmpty)
+{
+    sig::ThreadPool pool(2);
+    sig::Signal<void(const std::string &)> signal;
+    std::atomic<std::size_t> length{0};
+    for (int i = 0; i < 10; ++i)
+    {
+        signal.connectSlot([&length](const std::string &text) { length += text.size(); });
+    }
+    signal.emitParallel(pool, std::string("abc"));
+    EXPECT_EQ(length, 30u);
+
+    sig::Signal<int(), sig::VectorCombiner<int>> empty;
+    EXPECT_TRUE(empty.emitParallel(pool).empty());
+}
+
+// A slot running on the pool can emit in parallel again
+TEST(parallelEmission, Nested)
+{
+    sig::ThreadPool pool(2);
+    sig::Signal<int(int), sig::VectorCombiner<int>> inner;
+    inner.connectSlot([](int x) { return x; });
+    inner.connectSlot([](int x) { return x * 10; });
+
+    sig::Signal<int(int), sig::VectorCombiner<int>> outer;
+    for (int i = 0; i < 8; ++i)
+    {
+        outer.connectSlot([&](int x)
+        {
+            auto results = inner.emitParallel(pool, x);
+            return std::accumulate(results.begin(), results.end(), 0);
+        });
+    }
+    EXPECT_EQ(outer.emitParallel(pool, 1), std::vector<int>(8, 11));
+}
+
+/**
+ * Strand tests
+*/
+
+// Tasks of one strand never overlap and keep each producer's order
+TEST(strand, SerialFifo)
+{
+    sig::ThreadPool pool(4);
+    sig::Strand<sig::ThreadPool> strand(pool);
+    constexpr int producerCount = 4;
+    constexpr int taskCount = 2000;
+    std::atomic<int> running{0};
+    std::atomic<int> done{0};
+    bool overlapped = false;
+    std::vector<int> last(producerCount, -1);
+    bool ordered = true;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerCount; ++p)
+    {
+        producers.emplace_back([&, p]()
+        {
+            for (int i = 0; i < taskCount; ++i)
+            {
+                strand.post([&, p, i]()
+                {
+                    if (running.fetch_add(1) != 0)
+                    {
+                        overlapped = true;
+                    }
+                    ordered = ordered && last[p] == i - 1;
+                    last[p] = i;
+                    running.fetch_sub(1);
+                    ++done;
+                });
+            }
+        });
+    }
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+    while (done != producerCount * taskCount)
+    {
+        std::this_thread::yield();
+    }
+
+    EXPECT_FALSE(overlapped);
+    EXPECT_TRUE(ordered);
+}
+
+// Slots bound to a strand run one at a time even under parallel emission
+TEST(strand, QueuedSlots)
+{
+    sig::ThreadPool pool(3);
+    sig::Strand<sig::ThreadPool> strand(pool);
+    sig::Signal<void(int)> signal;
+    long sum = 0;
+    std::atomic<int> calls{0};
+    for (int i = 0; i < 16; ++i)
+    {
+        signal.connectSlot(strand, [&](int x) { sum += x; ++calls; });
+    }
+    for (int i = 0; i < 50; ++i)
+    {
+        signal.emitParallel(pool, 2);
+    }
+    while (calls != 16 * 50)
+    {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(sum, 16 * 50 * 2);
+}
+
+// A strand over an event loop runs when the loop drains, and tasks posted
+// from a running task come after it
+TEST(strand, OnEventLoop)
+{
+    sig::EventLoop loop;
+    sig::Strand<sig::EventLoop> strand(loop);
+    std::vector<int> order;
+    strand.post([&]()
+    {
+        order.push_back(1);
+        strand.post([&]() { order.push_back(3); });
+    });
+    strand.post([&]() { order.push_back(2); });
+    EXPECT_TRUE(order.empty());
+    while (loop.drain() != 0)
+    {
+    }
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+// A throwing task is reported by the pool and the strand runs the rest
+TEST(strand, TaskThrows)
+{
+    std::atomic<int> errors{0};
+    std::vector<int> order;
+    {
+        sig::ThreadPool pool(2, [&errors](std::exception_ptr) { ++errors; });
+        sig::Strand<sig::ThreadPool> strand(pool);
+        strand.post([&order]() { order.push_back(1); });
+        strand.post([]() { throw std::runtime_error("task failed"); });
+        strand.post([&order]() { order.push_back(2); });
+    }
+    EXPECT_EQ(errors, 1);
+    EXPECT_EQ(order, (std::vector<int>{1, 2}));
+}
+
+/**
+ * Mergeable combiner tests
+*/
+
+// merge folds in the combiner of the following results
+TEST(mergeableCombiner, Merge)
+{
+    sig::VectorCombiner<int> first;
+    sig::VectorCombiner<int> second;
+    first.combine(1);
+    second.combine(2);
+    second.combine(3);
+    first.merge(std::move(second));
+    EXPECT_EQ(first.result(), (std::vector<int>{1, 2, 3}));
+
+    sig::LastCombiner<int> last;
+    sig::LastCombiner<int> empty;
+    last.combine(4);
+    last.merge(std::move(empty));
+    EXPECT_EQ(last.result(), 4);
+
+    sig::MinCombiner<int> min;
+    sig::MinCombiner<int> otherMin;
+    min.combine(5);
+    otherMin.combine(2);
+    min.merge(std::move(otherMin));
+    EXPECT_EQ(min.result(), 2);
+
+    sig::MaxCombiner<int> max;
+    sig::MaxCombiner<int> noMax;
+    max.merge(std::move(noMax));
+    EXPECT_FALSE(max.result().has_value());
+
+    sig::CountCombiner count;
+    sig::CountCombiner otherCount;
+    count.combine('a');
+    otherCount.combine(1.5);
+    count.merge(std::move(otherCount));
+    EXPECT_EQ(count.result(), 2u);
+
+    EXPECT_TRUE(sig::hasMerge<sig::SumCombiner<int>>::value);
+    EXPECT_FALSE(sig::hasMerge<sig::FirstCombiner<int>>::value);
+}
+
+// The new combiners work on a plain emission
+TEST(mergeableCombiner, SerialEmission)
+{
+    sig::Signal<int(int), sig::SumCombiner<int>> sum;
+    sig::Signal<int(int), sig::MinCombiner<int>> min;
+    sig::Signal<int(int), sig::MaxCombiner<int>> max;
+    sig::Signal<int(int), sig::CountCombiner> count;
+    EXPECT_FALSE(min.emitSignal(1).has_value());
+    EXPECT_EQ(count.emitSignal(1), 0u);
+    for (int i : {3, -1, 7, 2})
+    {
+        sum.connectSlot([i](int x) { return i * x; });
+        min.connectSlot([i](int x) { return i * x; });
+        max.connectSlot([i](int x) { return i * x; });
+        count.connectSlot([i](int x) { return i * x; });
+    }
+    EXPECT_EQ(sum.emitSignal(2), 22);
+    EXPECT_EQ(min.emitSignal(2), -2);
+    EXPECT_EQ(max.emitSignal(2), 14);
+    EXPECT_EQ(count.emitSignal(2), 4u);
+}
+
+// Parallel emission with mergeable combiners matches the serial one
+TEST(mergeableCombiner, ParallelEmission)
+{
+    sig::ThreadPool pool(3);
+    sig::Signal<int(int), sig::SumCombiner<int>> sum;
+    sig::Signal<int(int), sig::MaxCombiner<int>> max;
+    sig::Signal<int(int), sig::VectorCombiner<int>> all;
+    sig::Signal<int(int), sig::LastCombiner<int>> last;
+    for (int i = 0; i < 50; ++i)
+    {
+        auto slot = [i](int x) { return (i * 37) % 11 + x; };
+        sum.connectSlot(slot);
+        max.connectSlot(slot);
+        all.connectSlot(slot);
+        last.connectSlot(slot);
+    }
+    EXPECT_EQ(sum.emitParallel(pool, 1), sum.emitSignal(1));
+    EXPECT_EQ(max.emitParallel(pool, 1), max.emitSignal(1));
+    EXPECT_EQ(all.emitParallel(pool, 1), all.emitSignal(1));
+    EXPECT_EQ(last.emitParallel(pool, 1), last.emitSignal(1));
+
+    sig::Signal<int(int), sig::SumCombiner<int>> empty;
+    EXPECT_EQ(empty.emitParallel(pool, 1), 0);
+}
+
+/**
+ * Future tests
+*/
+
+// A value set before or after getFuture reaches get, and the state is ready
+TEST(future, SetValueAndGet)
+{
+    sig::Promise<int> promise;
+    sig::Future<int> future = promise.getFuture();
+    EXPECT_TRUE(future.valid());
+    EXPECT_FALSE(future.isReady());
+    promise.setValue(42);
+    EXPECT_TRUE(future.isReady());
+    EXPECT_EQ(future.get(), 42);
+    EXPECT_FALSE(future.valid());
+
+    sig::Promise<std::string> text;
+    sig::Future<std::string> textFuture = text.getFuture();
+    text.setValue("done");
+    EXPECT_EQ(textFuture.get(), "done");
+}
+
+// Exceptions are rethrown by get, and a dropped promise breaks its future
+TEST(future, ExceptionAndBrokenPromise)
+{
+    sig::Promise<int> promise;
+    sig::Future<int> future = promise.getFuture();
+    promise.setException(std::make_exception_ptr(std::runtime_error("failed")));
+    EXPECT_THROW(future.get(), std::runtime_error);
+
+    sig::Future<void> broken;
+    {
+        sig::Promise<void> dropped;
+        broken = dropped.getFuture();
+    }
+    EXPECT_TRUE(broken.isReady());
+    EXPECT_THROW(broken.get(), std::future_error);
+}
+
+// get blocks until another thread sets the value
+TEST(future, WaitAcrossThreads)
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        sig::Promise<int> promise;
+        sig::Future<int> future = promise.getFuture();
+        std::thread producer([&promise, i]() { promise.setValue(i); });
+        EXPECT_EQ(future.get(), i);
+        producer.join();
+    }
+}
+
+// Continuations chain, whether attached before or after the value is set,
+// and an exception skips them down to the end of the chain
+TEST(future, ThenChains)
+{
+    sig::Promise<int> promise;
+    sig::Future<std::string> chained = promise.getFuture()
+        .then([](int x) { return x * 2; })
+        .then([](int x) { return std::to_string(x); });
+    EXPECT_FALSE(chained.isReady());
+    promise.setValue(21);
+    EXPECT_EQ(chained.get(), "42");
+
+    sig::Promise<void> ready;
+    sig::Future<void> readyFuture = ready.getFuture();
+    ready.setValue();
+    bool called = false;
+    readyFuture.then([&]() { called = true; }).get();
+    EXPECT_TRUE(called);
+
+    sig::Promise<int> failing;
+    bool skipped = true;
+    sig::Future<int> end = failing.getFuture()
+        .then([](int) -> int { throw std::runtime_error("first"); })
+        .then([&](int x) { skipped = false; return x; });
+    failing.setValue(1);
+    EXPECT_THROW(end.get(), std::runtime_error);
+    EXPECT_TRUE(skipped);
+}
+
+// Shared states are recycled instead of being allocated per promise
+TEST(future, PooledStates)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        sig::Promise<int> promise;
+        promise.getFuture();
+    }
+    std::size_t before = allocationCount;
+    for (int i = 0; i < 1000; ++i)
+    {
+        sig::Promise<int> promise;
+        sig::Future<int> future = promise.getFuture();
+        promise.setValue(i);
+        EXPECT_EQ(future.get(), i);
+    }
+    EXPECT_EQ(allocationCount, before);
+}
+
+/**
+ * Asynchronous emission tests
+*/
+
+// Without queued slots, the future is ready with the combined result
+TEST(emitAsync, DirectSlots)
+{
+    sig::Signal<int(int), sig::SumCombiner<int>> signal;
+    signal.connectSlot([](int x) { return x; });
+    signal.connectSlot([](int x) { return 2 * x; });
+    sig::Future<int> future = signal.emitAsync(5);
+    EXPECT_TRUE(future.isReady());
+    EXPECT_EQ(future.get(), 15);
+
+    sig::Signal<int(int), sig::SumCombiner<int>> throwing;
+    throwing.connectSlot([](int) -> int { throw std::runtime_error("slot"); });
+    EXPECT_THROW(throwing.emitAsync(1).get(), std::runtime_error);
+}
+
+// The future waits for the slots queued to an executor by the emission
+TEST(emitAsync, WaitsForQueuedSlots)
+{
+    sig::EventLoop loop;
+    sig::Signal<void(int)> signal;
+    std::vector<int> received;
+    signal.connectSlot([&](int x) { received.push_back(x); });
+    signal.connectSlot(loop, [&](int x) { received.push_back(10 * x); });
+    signal.connectSlot(loop, [&](int x) { received.push_back(100 * x); });
+
+    bool continued = false;
+    sig::Future<void> future = signal.emitAsync(1).then([&]() { continued = true; });
+    signal.emitSignal(2);
+    EXPECT_FALSE(future.isReady());
+    EXPECT_EQ(received, (std::vector<int>{1, 2}));
+
+    loop.drain(1);
+    EXPECT_FALSE(future.isReady());
+    loop.drain();
+    EXPECT_TRUE(future.isReady());
+    EXPECT_TRUE(continued);
+    future.get();
+    EXPECT_EQ(received, (std::vector<int>{1, 2, 10, 100, 20, 200}));
+}
+
+// A posted emission runs on the executor, and many can be in flight
+TEST(emitAsync, PostedEmission)
+{
+    sig::ThreadPool pool(2);
+    sig::Signal<int(int), sig::SumCombiner<int>> signal;
+    signal.connectSlot([](int x) { return x; });
+    signal.connectSlot([](int x) { return x + 1; });
+
+    std::vector<sig::Future<int>> futures;
+    for (int i = 0; i < 200; ++i)
+    {
+        futures.push_back(signal.emitAsync(pool, i));
+    }
+    for (int i = 0; i < 200; ++i)
+    {
+        EXPECT_EQ(futures[i].get(), 2 * i + 1);
+    }
+
+    sig::Signal<void(std::string)> text;
+    std::string copy;
+    text.connectSlot([&](const std::string &value) { copy = value; });
+    text.emitAsync(pool, std::string("posted")).get();
+    EXPECT_EQ(copy, "posted");
+}
+
+/**
+ * Reentrancy tests
+*/
+
+// A slot disconnecting itself finishes its call with its captures intact
+TEST(reentrancy, SelfDisconnect)
+{
+    sig::Signal<void(int)> signal;
+    std::vector<std::string> calls;
+    std::size_t id = 0;
+    signal.connectSlot([&](int) { calls.push_back("first"); });
+    id = signal.connectSlot([&, name = std::string(64, 'x')](int)
+    {
+        signal.disconnectSlot(id);
+        calls.push_back(name.substr(0, 4));
+    });
+    signal.connectSlot([&](int) { calls.push_back("last"); });
+
+    signal.emitSignal(1);
+    EXPECT_EQ(signal.slotCount(), 2u);
+    signal.emitSignal(2);
+    EXPECT_EQ(calls, (std::vector<std::string>{"first", "xxxx", "last", "first", "last"}));
+}
+
+// Slots disconnected by an earlier slot are skipped, the last one included,
+// and the disconnection is applied even when a slot throws
+TEST(reentrancy, DisconnectOthers)
+{
+    sig::Signal<int(int), sig::VectorCombiner<int>> signal;
+    std::size_t second = 0;
+    std::size_t last = 0;
+    signal.connectSlot([&](int x)
+    {
+        signal.disconnectSlot(second);
+        signal.disconnectSlot(last);
+        return x;
+    });
+    second = signal.connectSlot([](int x) { return 2 * x; });
+    signal.connectSlot([](int x) { return 3 * x; });
+    last = signal.connectSlot([](int x) { return 4 * x; });
+    EXPECT_EQ(signal.emitSignal(1), (std::vector<int>{1, 3}));
+    EXPECT_EQ(signal.emitSignal(2), (std::vector<int>{2, 6}));
+
+    sig::Signal<void()> throwing;
+    std::size_t victim = 0;
+    throwing.connectSlot([&]()
+    {
+        throwing.disconnectSlot(victim);
+        throw std::runtime_error("slot");
+    });
+    victim = throwing.connectSlot([]() {});
+    EXPECT_THROW(throwing.emitSignal(), std::runtime_error);
+    EXPECT_EQ(throwing.slotCount(), 1u);
+}
+
+// Slots connected during an emission are first called by the next one, and
+// can be disconnected before it
+TEST(reentrancy, ConnectDuringEmit)
+{
+    sig::Signal<void(int)> signal;
+    std::vector<int> calls;
+    bool connected = false;
+    std::size_t dropped = 0;
+    signal.connectSlot([&](int x)
+    {
+        calls.push_back(x);
+        if (!connected)
+        {
+            connected = true;
+            signal.connectSlot([&](int y) { calls.push_back(10 * y); });
+            dropped = signal.connectSlot([&](int y) { calls.push_back(100 * y); });
+            EXPECT_EQ(signal.slotCount(), 3u);
+            signal.disconnectSlot(dropped);
+        }
+    });
+
+    signal.emitSignal(1);
+    EXPECT_EQ(calls, (std::vector<int>{1}));
+    EXPECT_EQ(signal.slotCount(), 2u);
+    signal.emitSignal(2);
+    EXPECT_EQ(calls, (std::vector<int>{1, 2, 20}));
+}
+
+// Nested emissions see the slots of the outer one; changes made by either are
+// applied when the outermost emission returns
+TEST(reentrancy, NestedEmit)
+{
+    sig::Signal<void(int)> signal;
+    std::vector<int> calls;
+    std::size_t second = 0;
+    signal.connectSlot([&](int depth)
+    {
+        calls.push_back(depth);
+        if (depth == 0)
+        {
+            signal.emitSignal(1);
+            signal.connectSlot([&](int d) { calls.push_back(100 + d); });
+        }
+    });
+    second = signal.connectSlot([&](int depth)
+    {
+        calls.push_back(10 + depth);
+        if (depth == 1)
+        {
+            signal.disconnectSlot(second);
+        }
+    });
+
+    signal.emitSignal(0);
+    EXPECT_EQ(calls, (std::vector<int>{0, 1, 11}));
+    calls.clear();
+    signal.emitSignal(2);
+    EXPECT_EQ(calls, (std::vector<int>{2, 102}));
+}
+
+// Disconnecting during an emission does not allocate
+TEST(reentrancy, DisconnectNoAllocation)
+{
+    sig::Signal<void()> signal;
+    std::size_t id = 0;
+    signal.connectSlot([]() {});
+    id = signal.connectSlot([&]() { signal.disconnectSlot(id); });
+    signal.connectSlot([]() {});
+    std::size_t before = allocationCount;
+    signal.emitSignal();
+    EXPECT_EQ(allocationCount, before);
+    EXPECT_EQ(signal.slotCount(), 2u);
+}
+
+/**
+ * Connection handle tests
+*/
+
+void emptyFunction()
+{
+}
+
+// A handle disconnects its slot once, its copies see it, and a slot can
+// disconnect itself through its handle
+TEST(connectionHandle, Disconnect)
+{
+    sig::Signal<void(int)> signal;
+    int sum = 0;
+    sig::Connection connection = signal.connect([&](int x) { sum += x; });
+    sig::Connection copy = connection;
+    EXPECT_TRUE(connection.connected());
+    signal.emitSignal(1);
+    connection.disconnect();
+    EXPECT_FALSE(connection.connected());
+    EXPECT_FALSE(copy.connected());
+    copy.disconnect();
+    signal.emitSignal(2);
+    EXPECT_EQ(sum, 1);
+    EXPECT_EQ(signal.slotCount(), 0u);
+
+    sig::Connection once;
+    once = signal.connect([&](int x) { sum += x; once.disconnect(); });
+    signal.emitSignal(10);
+    signal.emitSignal(10);
+    EXPECT_EQ(sum, 11);
+}
+
+// A stale handle never reaches the slot reusing its entry
+TEST(connectionHandle, Generation)
+{
+    sig::Signal<int(), sig::VectorCombiner<int>> signal;
+    sig::Connection stale = signal.connect([]() { return 1; });
+    sig::Connection copy = stale;
+    stale.disconnect();
+    sig::Connection fresh = signal.connect([]() { return 2; });
+    EXPECT_FALSE(copy.connected());
+    copy.disconnect();
+    EXPECT_TRUE(fresh.connected());
+    EXPECT_EQ(signal.emitSignal(), (std::vector<int>{2}));
+}
+
+// Scoped handles disconnect when destroyed or replaced, unless released
+TEST(connectionHandle, Scoped)
+{
+    sig::Signal<void()> signal;
+    int calls = 0;
+    {
+        sig::ScopedConnection scoped = signal.connect([&]() { ++calls; });
+        signal.emitSignal();
+    }
+    signal.emitSignal();
+    EXPECT_EQ(calls, 1);
+
+    sig::ScopedConnection replaced = signal.connect([&]() { calls += 10; });
+    replaced = signal.connect([&]() { calls += 100; });
+    signal.emitSignal();
+    EXPECT_EQ(calls, 101);
+    EXPECT_EQ(signal.slotCount(), 1u);
+
+    sig::Connection kept;
+    {
+        sig::ScopedConnection scoped = signal.connect<&emptyFunction>();
+        kept = scoped.release();
+    }
+    EXPECT_TRUE(kept.connected());
+    EXPECT_EQ(signal.slotCount(), 2u);
+}
+
+// Handles outlive their signal, and follow it when it is moved
+TEST(connectionHandle, SignalLifetime)
+{
+    sig::Connection orphan;
+    sig::ScopedConnection scoped;
+    {
+        sig::Signal<void()> signal;
+        orphan = signal.connect([]() {});
+        scoped = signal.connect([]() {});
+    }
+    EXPECT_FALSE(orphan.connected());
+    orphan.disconnect();
+
+    sig::Signal<void()> first;
+    int calls = 0;
+    sig::Connection connection = first.connect([&]() { ++calls; });
+    sig::Signal<void()> second(std::move(first));
+    EXPECT_TRUE(connection.connected());
+    second.emitSignal();
+    connection.disconnect();
+    second.emitSignal();
+    EXPECT_EQ(calls, 1);
+
+    sig::Signal<void()> third;
+    sig::Connection overwritten = third.connect([]() {});
+    connection = second.connect([&]() { ++calls; });
+    third = std::move(second);
+    EXPECT_FALSE(overwritten.connected());
+    EXPECT_TRUE(connection.connected());
+    third.emitSignal();
+    EXPECT_EQ(calls, 2);
+}
+
+/**
+ * Tracked slot tests
+*/
+
+// A tracked slot stops being called once its object has expired, and is
+// disconnected afterwards
+TEST(trackedSlot, SkipsExpired)
+{
+    sig::Signal<int(int), sig::VectorCombiner<int>> signal;
+    auto object = std::make_shared<int>(10);
+    signal.connectSlot([](int x) { return x; });
+    signal.connectTracked([](int x) { return 2 * x; }, object);
+    EXPECT_EQ(signal.emitSignal(1), (std::vector<int>{1, 2}));
+
+    object.reset();
+    EXPECT_EQ(signal.emitSignal(2), (std::vector<int>{2}));
+    EXPECT_EQ(signal.slotCount(), 1u);
+}
+
+// Every tracked object must be alive, given as shared_ptr or weak_ptr, and
+// delegates can track their own object
+TEST(trackedSlot, SeveralObjectsAndDelegates)
+{
+    sig::Signal<int(int), sig::VectorCombiner<int>> signal;
+    auto first = std::make_shared<std::string>("first");
+    auto second = std::make_shared<double>(2.0);
+    std::weak_ptr<double> weakSecond = second;
+    signal.connectTracked([](int x) { return x; }, first, weakSecond);
+    auto receiver = std::make_shared<Receiver>();
+    receiver->setValue(100);
+    signal.connectTracked<&Receiver::add>(receiver);
+    EXPECT_EQ(signal.emitSignal(1), (std::vector<int>{1, 101}));
+
+    second.reset();
+    EXPECT_EQ(signal.emitSignal(2), (std::vector<int>{102}));
+    receiver.reset();
+    EXPECT_TRUE(signal.emitSignal(3).empty());
+    EXPECT_EQ(signal.slotCount(), 0u);
+}
+
+// The tracked objects stay alive until the call returns, without allocating
+TEST(trackedSlot, AliveDuringCall)
+{
+    struct Flag
+    {
+        explicit Flag(bool *destroyed) : destroyed(destroyed) {}
+        ~Flag() { *destroyed = true; }
+        bool *destroyed;
+    };
+
+    sig::Signal<void()> signal;
+    bool destroyed = false;
+    auto owner = std::make_shared<Flag>(&destroyed);
+    bool aliveAtEnd = false;
+    signal.connectTracked([&]()
+    {
+        owner.reset();
+        aliveAtEnd = !destroyed;
+    }, owner);
+    std::size_t before = allocationCount;
+    signal.emitSignal();
+    EXPECT_EQ(allocationCount, before);
+    EXPECT_TRUE(aliveAtEnd);
+    EXPECT_TRUE(destroyed);
+}
+
+// Parallel and range combiner emissions keep the tracked objects alive too,
+// also when the owner is reset on another thread
+TEST(trackedSlot, AliveDuringParallelCall)
+{
+    struct Flag
+    {
+        explicit Flag(std::atomic<bool> *destroyed) : destroyed(destroyed) {}
+        ~Flag() { *destroyed = true; }
+        std::atomic<bool> *destroyed;
+    };
+
+    sig::Signal<int(), sig::VectorCombiner<int>> signal;
+    std::atomic<bool> destroyed{false};
+    std::atomic<bool> entered{false};
+    std::atomic<bool> reset{false};
+    auto owner = std::make_shared<Flag>(&destroyed);
+    signal.connectTracked([&]()
+    {
+        entered = true;
+        while (!reset)
+        {
+            std::this_thread::yield();
+        }
+        return destroyed ? 0 : 1;
+    }, owner);
+
+    std::thread resetter([&]()
+    {
+        while (!entered)
+        {
+            std::this_thread::yield();
+        }
+        owner.reset();
+        reset = true;
+    });
+    sig::ThreadPool pool(2);
+    EXPECT_EQ(signal.emitParallel(pool), (std::vector<int>{1}));
+    resetter.join();
+    EXPECT_TRUE(destroyed);
+
+    sig::Signal<int(), SumRangeCombiner> range;
+    destroyed = false;
+    owner = std::make_shared<Flag>(&destroyed);
+    range.connectTracked([&]()
+    {
+        owner.reset();
+        return destroyed ? 0 : 1;
+    }, owner);
+    EXPECT_EQ(range.emitSignal(), 1);
+    EXPECT_TRUE(destroyed);
+}
+
+// Expired slots are only erased once they make up a quarter of the slots,
+// and every emission path skips them
+TEST(trackedSlot, BatchedSweep)
+{
+    sig::Signal<int(int), sig::SumCombiner<int>> signal;
+    std::vector<std::shared_ptr<int>> objects;
+    for (int i = 0; i < 40; ++i)
+    {
+        signal.connectSlot([](int x) { return x; });
+    }
+    for (int i = 0; i < 60; ++i)
+    {
+        objects.push_back(std::make_shared<int>(i));
+        signal.connectTracked([](int x) { return x; }, objects.back());
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        objects[i].reset();
+    }
+    EXPECT_EQ(signal.emitSignal(1), 90);
+    EXPECT_EQ(signal.slotCount(), 100u);
+
+    for (int i = 10; i < 30; ++i)
+    {
+        objects[i].reset();
+    }
+    sig::ThreadPool pool(2);
+    EXPECT_EQ(signal.emitParallel(pool, 1), 70);
+    EXPECT_EQ(signal.slotCount(), 70u);
+    EXPECT_EQ(signal.emitSignal(1), 70);
+}
+
+/**
+ * Connection blocking tests
+*/
+
+// Blocked slots are skipped but keep their id and place, across bitmask words
+TEST(connectionBlocking, BlockAndUnblock)
+{
+    sig::Signal<int(), sig::VectorCombiner<int>> signal;
+    std::vector<std::size_t> ids;
+    for (int i = 0; i < 130; ++i)
+    {
+        ids.push_back(signal.connectSlot([i]() { return i; }));
+    }
+    std::vector<int> expected;
+    for (int i = 0; i < 130; ++i)
+    {
+        if (i % 3 == 0)
+        {
+            signal.block(ids[i]);
+        }
+        else
+        {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_TRUE(signal.isBlocked(ids[0]));
+    EXPECT_FALSE(signal.isBlocked(ids[1]));
+    EXPECT_EQ(signal.slotCount(), 130u);
+    EXPECT_EQ(signal.emitSignal(), expected);
+
+    for (int i = 0; i < 130; i += 3)
+    {
+        signal.unblock(ids[i]);
+    }
+    std::vector<int> all(130);
+    std::iota(all.begin(), all.end(), 0);
+    EXPECT_EQ(signal.emitSignal(), all);
+
+    signal.disconnectSlot(ids[5]);
+    signal.block(ids[5]);
+    EXPECT_FALSE(signal.isBlocked(ids[5]));
+}
+
+// Slots blocked during an emission are skipped by it, including the last one
+TEST(connectionBlocking, DuringEmission)
+{
+    sig::Signal<void()> signal;
+    std::vector<int> order;
+    std::size_t second = 0;
+    std::size_t last = 0;
+    signal.connectSlot([&]() { order.push_back(0); signal.block(second); signal.block(last); });
+    second = signal.connectSlot([&]() { order.push_back(1); });
+    signal.connectSlot([&]() { order.push_back(2); });
+    last = signal.connectSlot([&]() { order.push_back(3); });
+    signal.emitSignal();
+    EXPECT_EQ(order, (std::vector<int>{0, 2}));
+
+    // slots connected and blocked during an emission stay blocked after it
+    sig::Signal<void()> nested;
+    int calls = 0;
+    std::size_t added = 0;
+    nested.connectSlot([&]()
+                       {
+        if (added == 0)
+        {
+            added = nested.connectSlot([&]() { ++calls; });
+            nested.block(added);
+            EXPECT_TRUE(nested.isBlocked(added));
+        } });
+    nested.emitSignal();
+    nested.emitSignal();
+    EXPECT_EQ(calls, 0);
+    nested.unblock(added);
+    nested.emitSignal();
+    EXPECT_EQ(calls, 1);
+}
+
+// A slot unblocked during the emission after the last enabled one does not
+// run before it
+TEST(connectionBlocking, UnblockAfterLast)
+{
+    sig::Signal<void()> signal;
+    std::vector<int> order;
+    std::vector<std::size_t> ids;
+    for (int i = 0; i < 70; ++i)
+    {
+        ids.push_back(signal.connectSlot([&order, &signal, &ids, i]()
+        {
+            order.push_back(i);
+            if (i == 0)
+            {
+                signal.unblock(ids[69]);
+            }
+        }));
+    }
+    signal.block(ids[69]);
+    std::vector<int> expected(69);
+    std::iota(expected.begin(), expected.end(), 0);
+    signal.emitSignal();
+    EXPECT_EQ(order, expected);
+
+    order.clear();
+    signal.emitSignal();
+    expected.push_back(69);
+    EXPECT_EQ(order, expected);
+}
+
+// Connection handles block their slot, for every way of emitting
+TEST(connectionBlocking, ConnectionsAndEmissions)
+{
+    sig::Signal<int(int), sig::SumCombiner<int>> signal;
+    sig::Connection first = signal.connect([](int x) { return x; });
+    sig::Connection second = signal.connect([](int x) { return 10 * x; });
+    signal.block(second);
+    EXPECT_TRUE(signal.isBlocked(second));
+    EXPECT_EQ(signal.emitSignal(1), 1);
+
+    sig::Signal<int(int), SumRangeCombiner> range;
+    range.connectSlot([](int x) { return x; });
+    std::size_t blocked = range.connectSlot([](int x) { return 10 * x; });
+    range.block(blocked);
+    EXPECT_EQ(range.emitSignal(2), 2);
+
+    sig::ThreadPool pool(2);
+    EXPECT_EQ(signal.emitParallel(pool, 3), 3);
+
+    signal.block(first);
+    signal.unblock(second);
+    EXPECT_EQ(signal.emitSignal(1), 10);
+}
+
+// Blocking and unblocking do not allocate
+TEST(connectionBlocking, NoAllocation)
+{
+    sig::Signal<void(int)> signal;
+    std::size_t id = signal.connectSlot([](int) {});
+    signal.connectSlot([](int) {});
+    std::size_t before = allocationCount;
+    signal.block(id);
+    signal.emitSignal(1);
+    signal.unblock(id);
+    signal.emitSignal(1);
+    EXPECT_EQ(allocationCount, before);
+}
+
+/**
+ * Batch connection tests
+*/
+
+// connectSlots connects a range in order and hands out the ids
+TEST(connectionBatch, ConnectSlots)
+{
+    sig::Signal<int(), sig::VectorCombiner<int>> signal;
+    std::vector<std::function<int()>> slots;
+    for (int i = 0; i < 100; ++i)
+    {
+        slots.push_back([i]() { return i; });
+    }
+    std::vector<std::size_t> ids;
+    signal.connectSlots(slots, std::back_inserter(ids));
+    ASSERT_EQ(ids.size(), 100u);
+    EXPECT_EQ(signal.slotCount(), 100u);
+
+    std::vector<int> expected(100);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(signal.emitSignal(), expected);
+
+    signal.disconnectSlot(ids[0]);
+    signal.connectSlots(std::vector<int (*)()>{&callback_3, &callback_3});
+    expected.erase(expected.begin());
+    expected.push_back(1);
+    expected.push_back(1);
+    EXPECT_EQ(signal.emitSignal(), expected);
+}
+
+// disconnectIf disconnects the slots whose id is picked, in one pass
+TEST(connectionBatch, DisconnectIf)
+{
+    sig::Signal<int(), sig::VectorCombiner<int>> signal;
+    std::vector<std::size_t> odd;
+    sig::Connection kept;
+    sig::Connection dropped;
+    for (int i = 0; i < 100; ++i)
+    {
+        std::size_t id = signal.connectSlot([i]() { return i; });
+        if (i % 2)
+        {
+            odd.push_back(id);
+        }
+    }
+    kept = signal.connect([]() { return 100; });
+    dropped = signal.connect([]() { return 101; });
+
+    std::size_t erased = signal.disconnectIf([&](std::size_t id)
+                                             { return id == dropped.id() || std::find(odd.begin(), odd.end(), id) != odd.end(); });
+    EXPECT_EQ(erased, 51u);
+    EXPECT_EQ(signal.slotCount(), 51u);
+    EXPECT_TRUE(kept.connected());
+    EXPECT_FALSE(dropped.connected());
+
+    std::vector<int> expected;
+    for (int i = 0; i < 100; i += 2)
+    {
+        expected.push_back(i);
+    }
+    expected.push_back(100);
+    EXPECT_EQ(signal.emitSignal(), expected);
+    EXPECT_EQ(signal.disconnectIf([](std::size_t) { return false; }), 0u);
+}
+
+// disconnectAll empties the signal, even from a slot during an emission
+TEST(connectionBatch, DisconnectAll)
+{
+    sig::Signal<void()> signal;
+    auto owned = std::make_shared<int>(0);
+    int calls = 0;
+    signal.connectSlot([&, owned]()
+                       {
+        ++calls;
+        signal.disconnectAll(); });
+    signal.connectSlot([&]() { ++calls; });
+    signal.emitSignal();
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(signal.slotCount(), 0u);
+    EXPECT_EQ(owned.use_count(), 1);
+
+    std::size_t id = signal.connectSlot([&]() { ++calls; });
+    signal.emitSignal();
+    EXPECT_EQ(calls, 2);
+    signal.disconnectAll();
+    signal.disconnectSlot(id);
+    signal.emitSignal();
+    EXPECT_EQ(calls, 2);
+}
+
+/**
+ * Clone and swap tests
+*/
+
+static_assert(std::is_nothrow_move_constructible_v<sig::Signal<void(int)>>);
+static_assert(std::is_nothrow_move_assignable_v<sig::Signal<int(), sig::VectorCombiner<int>>>);
+static_assert(std::is_nothrow_swappable_v<sig::Signal<int(int), sig::SumCombiner<int>>>);
+static_assert(!std::is_copy_constructible_v<sig::Signal<void(int)>>);
+
+// A clone calls the same slots, which are shared rather than copied
+TEST(cloneAndSwap, CloneSharesSlots)
+{
+    sig::Signal<int(int), sig::VectorCombiner<int>> prototype;
+    int calls = 0;
+    prototype.connectSlot([&calls](int x) { ++calls; return x; });
+    std::size_t id = prototype.connectSlot([counter = 0](int x) mutable { return x + ++counter; });
+    prototype.connectSlot<&callback_15>();
+
+    sig::Signal<int(int), sig::VectorCombiner<int>> clone = prototype.clone();
+    EXPECT_EQ(clone.slotCount(), 3u);
+    EXPECT_EQ(prototype.emitSignal(10), (std::vector<int>{10, 11, 20}));
+    EXPECT_EQ(clone.emitSignal(10), (std::vector<int>{10, 12, 20}));
+    EXPECT_EQ(calls, 2);
+
+    // ids carry over, and each signal changes its slots on its own
+    clone.disconnectSlot(id);
+    clone.connectSlot([](int x) { return -x; });
+    prototype.block(id);
+    EXPECT_EQ(prototype.emitSignal(1), (std::vector<int>{1, 2}));
+    EXPECT_EQ(clone.emitSignal(1), (std::vector<int>{1, 2, -1}));
+    prototype.unblock(id);
+    EXPECT_EQ(prototype.emitSignal(1), (std::vector<int>{1, 4, 2}));
+}
+
+// Shared slots live as long as one signal calls them, clones of clones included
+TEST(cloneAndSwap, SharedSlotLifetime)
+{
+    auto owned = std::make_shared<int>(5);
+    std::optional<sig::Signal<int(), sig::SumCombiner<int>>> prototype;
+    prototype.emplace();
+    prototype->connectSlot([owned]() { return *owned; });
+    auto tracked = std::make_shared<int>(0);
+    prototype->connectTracked([]() { return 1; }, tracked);
+
+    sig::Signal<int(), sig::SumCombiner<int>> first = prototype->clone();
+    prototype->connectSlot([]() { return 10; });
+    sig::Signal<int(), sig::SumCombiner<int>> second = prototype->clone();
+    sig::Signal<int(), sig::SumCombiner<int>> third = first.clone();
+    prototype.reset();
+    EXPECT_EQ(first.emitSignal(), 6);
+    EXPECT_EQ(second.emitSignal(), 16);
+    EXPECT_EQ(third.emitSignal(), 6);
+
+    tracked.reset();
+    EXPECT_EQ(second.emitSignal(), 15);
+    first.disconnectAll();
+    second.disconnectAll();
+    EXPECT_EQ(owned.use_count(), 2);
+    third.disconnectAll();
+    EXPECT_EQ(owned.use_count(), 1);
+}
+
+// A shared slot is destroyed as soon as no signal connects it anymore
+TEST(cloneAndSwap, DisconnectSharedSlot)
+{
+    auto owned = std::make_shared<int>(1);
+    sig::Signal<int(), sig::SumCombiner<int>> prototype;
+    std::size_t id = prototype.connectSlot([owned]() { return *owned; });
+    prototype.connectSlot([]() { return 2; });
+    EXPECT_EQ(owned.use_count(), 2);
+
+    std::optional<sig::Signal<int(), sig::SumCombiner<int>>> clone;
+    clone.emplace(prototype.clone());
+    prototype.disconnectSlot(id);
+    EXPECT_EQ(owned.use_count(), 2);
+    EXPECT_EQ(clone->emitSignal(), 3);
+    clone->disconnectSlot(id);
+    EXPECT_EQ(owned.use_count(), 1);
+
+    id = prototype.connectSlot([owned]() { return *owned; });
+    clone.emplace(prototype.clone());
+    clone.reset();
+
+    // left alone with its shared slots, the prototype takes them back
+    for (int i = 0; i < 4; ++i)
+    {
+        prototype.disconnectSlot(prototype.connectSlot([]() { return 0; }));
+    }
+    EXPECT_EQ(prototype.emitSignal(), 3);
+    prototype.disconnectSlot(id);
+    EXPECT_EQ(owned.use_count(), 1);
+    EXPECT_EQ(prototype.emitSignal(), 2);
+}
+
+// Cloning a const signal shares its table whole, whatever the slot count
+TEST(cloneAndSwap, ClonePrototypeTable)
+{
+    sig::Signal<int(int), sig::SumCombiner<int>> signal;
+    for (int i = 0; i < 1000; ++i)
+    {
+        signal.connectSlot([i](int x) { return x + i; });
+    }
+    const sig::Signal<int(int), sig::SumCombiner<int>> &prototype = signal;
+
+    std::size_t before = allocationCount;
+    sig::Signal<int(int), sig::SumCombiner<int>> first = prototype.clone();
+    sig::Signal<int(int), sig::SumCombiner<int>> second = prototype.clone();
+    EXPECT_LE(allocationCount - before, 2u);
+    EXPECT_EQ(first.emitSignal(1), 1000 + 499500);
+    EXPECT_EQ(second.emitSignal(1), 1000 + 499500);
+
+    // a change gives the clone a table of its own, the prototype's untouched
+    first.connectSlot([](int) { return 1; });
+    second.disconnectAll();
+    EXPECT_EQ(prototype.slotCount(), 1000u);
+    EXPECT_EQ(signal.emitSignal(0), 499500);
+    EXPECT_EQ(first.emitSignal(0), 499501);
+    EXPECT_EQ(second.emitSignal(0), 0);
+}
+
+// A slot may change a clone still sharing the table while it emits
+TEST(cloneAndSwap, ChangeSharedDuringEmission)
+{
+    sig::Signal<int(), sig::VectorCombiner<int>> prototype;
+    std::size_t second = 0;
+    sig::Signal<int(), sig::VectorCombiner<int>> *clone = nullptr;
+    prototype.connectSlot([&]() { if (clone) { clone->disconnectSlot(second); clone->connectSlot([]() { return 4; }); } return 1; });
+    second = prototype.connectSlot([]() { return 2; });
+    prototype.connectSlot([]() { return 3; });
+
+    sig::Signal<int(), sig::VectorCombiner<int>> copy = prototype.clone();
+    clone = &copy;
+    EXPECT_EQ(copy.emitSignal(), (std::vector<int>{1, 3}));
+    clone = nullptr;
+    EXPECT_EQ(copy.emitSignal(), (std::vector<int>{1, 3, 4}));
+    EXPECT_EQ(prototype.emitSignal(), (std::vector<int>{1, 2, 3}));
+}
+
+// Left alone, a signal takes its shared slots back by emitting alone
+TEST(cloneAndSwap, ReclaimOnEmission)
+{
+    struct Where
+    {
+        const void **at;
+        void operator()() { *at = this; }
+    };
+    const void *at = nullptr;
+    sig::Signal<void()> prototype;
+    prototype.connectSlot(Where{&at});
+    std::optional<sig::Signal<void()>> clone;
+    clone.emplace(prototype.clone());
+    prototype.connectSlot([]() {});
+
+    prototype.emitSignal();
+    const void *shared = at;
+    clone->emitSignal();
+    EXPECT_EQ(at, shared);
+
+    // within as many emissions as there are slots
+    clone.reset();
+    prototype.emitSignal();
+    prototype.emitSignal();
+    EXPECT_NE(at, shared);
+}
+
+// Swapping and moving exchange the slots, connection handles following them
+TEST(cloneAndSwap, SwapAndMove)
+{
+    sig::Signal<int(), sig::SumCombiner<int>> a;
+    sig::Signal<int(), sig::SumCombiner<int>> b;
+    sig::Connection connection = a.connect([]() { return 1; });
+    b.connectSlot([]() { return 2; });
+    b.connectSlot([]() { return 3; });
+
+    swap(a, b);
+    EXPECT_EQ(a.emitSignal(), 5);
+    EXPECT_EQ(b.emitSignal(), 1);
+    EXPECT_TRUE(connection.connected());
+    connection.disconnect();
+    EXPECT_EQ(b.slotCount(), 0u);
+
+    sig::Signal<int(), sig::SumCombiner<int>> moved(std::move(a));
+    EXPECT_EQ(moved.emitSignal(), 5);
+    a = std::move(moved);
+    EXPECT_EQ(a.emitSignal(), 5);
+}
+
+// A moved-from signal is empty and takes new slots
+TEST(cloneAndSwap, ReuseMovedFrom)
+{
+    sig::Signal<int(), sig::SumCombiner<int>> source;
+    std::size_t id = source.connectSlot([]() { return 1; });
+    source.connectSlot([]() { return 2; });
+    source.disconnectSlot(id);
+
+    sig::Signal<int(), sig::SumCombiner<int>> target(std::move(source));
+    EXPECT_EQ(source.slotCount(), 0u);
+    source.connectSlot([]() { return 4; });
+    EXPECT_EQ(source.emitSignal(), 4);
+    EXPECT_EQ(target.emitSignal(), 2);
+
+    target.disconnectSlot(target.connectSlot([]() { return 8; }));
+    source = std::move(target);
+    EXPECT_EQ(target.slotCount(), 0u);
+    target.connectSlot([]() { return 16; });
+    EXPECT_EQ(target.emitSignal(), 16);
+    EXPECT_EQ(source.emitSignal(), 2);
+}
+
 /**
  * Own combiner : FirstCombiner tests
 */
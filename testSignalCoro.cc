@@ -0,0 +1,239 @@
+#include "SignalCoro.h"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/**
+ * Task tests
+*/
+
+sig::Task<int> twice(int value)
+{
+    co_return 2 * value;
+}
+
+sig::Task<int> sumOfTwice(int a, int b)
+{
+    int first = co_await twice(a);
+    int second = co_await twice(b);
+    co_return first + second;
+}
+
+sig::Task<void> fail()
+{
+    throw std::runtime_error("task");
+    co_return;
+}
+
+// Tasks are lazy, chain through co_await, and spawn runs them into a future
+TEST(task, AwaitAndSpawn)
+{
+    bool started = false;
+    auto lazy = [&]() -> sig::Task<int>
+    {
+        started = true;
+        co_return 1;
+    };
+    sig::Task<int> task = lazy();
+    EXPECT_FALSE(started);
+    EXPECT_EQ(sig::spawn(std::move(task)).get(), 1);
+    EXPECT_TRUE(started);
+
+    EXPECT_EQ(sig::spawn(sumOfTwice(1, 2)).get(), 6);
+}
+
+// Exceptions cross co_await and reach the future
+TEST(task, Exceptions)
+{
+    auto rethrow = []() -> sig::Task<std::string>
+    {
+        co_await fail();
+        co_return "unreachable";
+    };
+    EXPECT_THROW(sig::spawn(rethrow()).get(), std::runtime_error);
+}
+
+/**
+ * Awaiting emissions tests
+*/
+
+sig::Task<std::vector<int>> collect(sig::Signal<void(int)> &signal, int count)
+{
+    std::vector<int> values;
+    for (int i = 0; i < count; ++i)
+    {
+        values.push_back(co_await signal.next());
+    }
+    co_return values;
+}
+
+// next() resumes the coroutine with the arguments of every following emission
+TEST(awaitEmission, Next)
+{
+    sig::Signal<void(int)> signal;
+    sig::Future<std::vector<int>> future = sig::spawn(collect(signal, 3));
+    signal.emitSignal(1);
+    signal.emitSignal(2);
+    EXPECT_FALSE(future.isReady());
+    signal.emitSignal(3);
+    EXPECT_TRUE(future.isReady());
+    EXPECT_EQ(future.get(), (std::vector<int>{1, 2, 3}));
+    signal.emitSignal(4);
+}
+
+// Several arguments come as a tuple, none as void; waiters resume in the order
+// they started waiting, after the slots
+TEST(awaitEmission, ArgumentsAndOrder)
+{
+    sig::Signal<void(std::string, int)> pair;
+    auto awaitPair = [](sig::Signal<void(std::string, int)> &signal) -> sig::Task<std::tuple<std::string, int>>
+    {
+        co_return co_await signal.next();
+    };
+    sig::Future<std::tuple<std::string, int>> pairFuture = sig::spawn(awaitPair(pair));
+    pair.emitSignal(std::string("answer"), 42);
+    EXPECT_EQ(pairFuture.get(), std::make_tuple(std::string("answer"), 42));
+
+    sig::Signal<void()> signal;
+    std::vector<int> order;
+    signal.connectSlot([&]() { order.push_back(0); });
+    auto waiter = [&](int id) -> sig::Task<void>
+    {
+        co_await signal.next();
+        order.push_back(id);
+    };
+    sig::Future<void> first = sig::spawn(waiter(1));
+    sig::Future<void> second = sig::spawn(waiter(2));
+    signal.emitSignal();
+    first.get();
+    second.get();
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+}
+
+// A coroutine waiting again while resumed waits for the following emission
+TEST(awaitEmission, WaitAgainWhileResumed)
+{
+    sig::Signal<void(int)> signal;
+    sig::Future<std::vector<int>> future = sig::spawn(collect(signal, 2));
+    signal.emitSignal(1);
+    EXPECT_FALSE(future.isReady());
+    signal.emitSignal(2);
+    EXPECT_EQ(future.get(), (std::vector<int>{1, 2}));
+}
+
+// Waiting coroutines follow the signal when it is moved or swapped
+TEST(awaitEmission, MoveAndSwap)
+{
+    sig::Signal<void(int)> a;
+    sig::Future<std::vector<int>> moved = sig::spawn(collect(a, 1));
+    sig::Signal<void(int)> b(std::move(a));
+    b.emitSignal(1);
+    EXPECT_EQ(moved.get(), (std::vector<int>{1}));
+
+    sig::Signal<void(int)> c;
+    sig::Future<std::vector<int>> swapped = sig::spawn(collect(b, 1));
+    swap(b, c);
+    b.emitSignal(0);
+    EXPECT_FALSE(swapped.isReady());
+    c.emitSignal(2);
+    EXPECT_EQ(swapped.get(), (std::vector<int>{2}));
+
+    // a waiter dropped after a move unregisters from the new signal
+    {
+        auto dropped = c.next();
+        dropped.await_suspend(std::noop_coroutine());
+        b = std::move(c);
+    }
+    sig::Future<std::vector<int>> last = sig::spawn(collect(b, 1));
+    b.emitSignal(3);
+    EXPECT_EQ(last.get(), (std::vector<int>{3}));
+}
+
+// Coroutines waiting on a signal moved onto keep waiting on it
+TEST(awaitEmission, MoveAssignKeepsWaiters)
+{
+    sig::Signal<void(int)> source;
+    sig::Signal<void(int)> target;
+    std::vector<int> order;
+    auto waiter = [&](sig::Signal<void(int)> &signal, int id) -> sig::Task<void>
+    {
+        order.push_back(id + co_await signal.next());
+    };
+    sig::Future<void> waitingTarget = sig::spawn(waiter(target, 10));
+    sig::Future<void> waitingSource = sig::spawn(waiter(source, 20));
+    target = std::move(source);
+    source.emitSignal(0);
+    EXPECT_FALSE(waitingTarget.isReady());
+    target.emitSignal(1);
+    ASSERT_TRUE(waitingTarget.isReady());
+    waitingTarget.get();
+    waitingSource.get();
+    EXPECT_EQ(order, (std::vector<int>{11, 21}));
+}
+
+/**
+ * Coroutine slots tests
+*/
+
+// The combiner awaits the tasks of the slots in connection order
+TEST(coroutineSlots, CombinerAwaitsTasks)
+{
+    sig::Signal<sig::Task<int>(int), sig::AwaitCombiner<sig::SumCombiner<int>>> signal;
+    signal.connectSlot(&twice);
+    signal.connectSlot([](int x) -> sig::Task<int> { co_return x + 1; });
+    EXPECT_EQ(sig::spawn(signal.emitSignal(3)).get(), 10);
+
+    sig::Signal<sig::Task<void>(int), sig::AwaitCombiner<sig::DiscardCombiner>> discard;
+    int sum = 0;
+    discard.connectSlot([&sum](int x) -> sig::Task<void> { sum += x; co_return; });
+    discard.connectSlot([&sum](int x) -> sig::Task<void> { sum += 10 * x; co_return; });
+    sig::Task<void> pending = discard.emitSignal(1);
+    EXPECT_EQ(sum, 0);
+    sig::spawn(std::move(pending)).get();
+    EXPECT_EQ(sum, 11);
+}
+
+// Slots suspended on events hold the result back without blocking a thread
+TEST(coroutineSlots, SuspendedSlots)
+{
+    sig::Signal<void(int)> trigger;
+    sig::Signal<sig::Task<int>(int), sig::AwaitCombiner<sig::VectorCombiner<int>>> request;
+    auto slot = [&trigger](int x) -> sig::Task<int>
+    {
+        co_return x + co_await trigger.next();
+    };
+    request.connectSlot(slot);
+    request.connectSlot(slot);
+
+    sig::Future<std::vector<int>> future = sig::spawn(request.emitSignal(1));
+    EXPECT_FALSE(future.isReady());
+    trigger.emitSignal(10);
+    EXPECT_FALSE(future.isReady());
+    trigger.emitSignal(20);
+    EXPECT_EQ(future.get(), (std::vector<int>{11, 21}));
+}
+
+// A combiner stopping early leaves the remaining slot bodies unstarted, and
+// exceptions of slot bodies reach the awaiting coroutine
+TEST(coroutineSlots, StopAndExceptions)
+{
+    sig::Signal<sig::Task<int>(int), sig::AwaitCombiner<sig::FirstCombiner<int>>> signal;
+    bool secondStarted = false;
+    signal.connectSlot(&twice);
+    signal.connectSlot([&secondStarted](int x) -> sig::Task<int> { secondStarted = true; co_return x; });
+    EXPECT_EQ(sig::spawn(signal.emitSignal(4)).get(), 8);
+    EXPECT_FALSE(secondStarted);
+
+    sig::Signal<sig::Task<void>(), sig::AwaitCombiner<sig::DiscardCombiner>> failing;
+    failing.connectSlot(&fail);
+    EXPECT_THROW(sig::spawn(failing.emitSignal()).get(), std::runtime_error);
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}